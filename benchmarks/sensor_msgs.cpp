@@ -0,0 +1,136 @@
+#include <ros/ros.h>
+#include <rosmath/rosmath.h>
+#include <rosmath/sensor_msgs/random.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace rosmath;
+
+/**
+ * Throughput of synthetic sensor streams through the conversion and
+ * transform paths: many virtual sensors, one Philox stream each.
+ *
+ * usage: rosmath_benchmark_sensor_msgs [sensors] [frames]
+ */
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(const Clock::time_point& start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const std::string& name, size_t messages, size_t points, double seconds)
+{
+    std::cout << "-- " << name << ": "
+        << messages / seconds << " msgs/s, "
+        << points / seconds * 1e-6 << " Mpoints/s" << std::endl;
+}
+
+geometry_msgs::TransformStamped sensor_to_base(const std::string& sensor_frame)
+{
+    geometry_msgs::TransformStamped T;
+    T.header.frame_id = "base_link";
+    T.child_frame_id = sensor_frame;
+    T.transform.translation.x = 0.2;
+    T.transform.translation.z = 0.5;
+    T.transform.rotation.z = std::sin(0.05);
+    T.transform.rotation.w = std::cos(0.05);
+    return T;
+}
+
+void benchmark_laser_scans(size_t sensors, size_t frames)
+{
+    random::LaserScanParams params;
+    params.beams = 1080;
+    params.x = 1.0;
+    params.y = -0.5;
+
+    sensor_msgs::LaserScan scan;
+    scan.header.frame_id = "laser";
+    sensor_msgs::PointCloud pcl, pcl_base;
+    const geometry_msgs::TransformStamped T = sensor_to_base(scan.header.frame_id);
+
+    double t_generate = 0.0, t_convert = 0.0, t_transform = 0.0;
+    size_t points = 0;
+
+    for(size_t s=0; s<sensors; s++)
+    {
+        const random::Philox gen(42, s);
+        for(size_t f=0; f<frames; f++)
+        {
+            Clock::time_point start = Clock::now();
+            random::laser_scan_fill(gen, scan, params, 3 * params.beams * f);
+            t_generate += seconds_since(start);
+
+            start = Clock::now();
+            pcl.points.clear();
+            pcl.channels.clear();
+            convert(scan, pcl);
+            t_convert += seconds_since(start);
+
+            start = Clock::now();
+            pcl_base = T * pcl;
+            t_transform += seconds_since(start);
+
+            points += pcl.points.size();
+        }
+    }
+
+    const size_t messages = sensors * frames;
+    std::cout << "LaserScan (" << params.beams << " beams)" << std::endl;
+    report("generate", messages, messages * params.beams, t_generate);
+    report("LaserScan -> PointCloud", messages, messages * params.beams, t_convert);
+    report("TransformStamped * PointCloud", messages, points, t_transform);
+}
+
+void benchmark_point_clouds(size_t sensors, size_t frames)
+{
+    random::PointCloudParams params;
+    params.points = 20000;
+    params.surface = random::Surface::BOX;
+    params.size = 4.0;
+
+    sensor_msgs::PointCloud pcl, pcl_base;
+    pcl.header.frame_id = "depth";
+    const geometry_msgs::TransformStamped T = sensor_to_base(pcl.header.frame_id);
+
+    double t_generate = 0.0, t_transform = 0.0;
+
+    for(size_t s=0; s<sensors; s++)
+    {
+        const random::Philox gen(42, sensors + s);
+        for(size_t f=0; f<frames; f++)
+        {
+            Clock::time_point start = Clock::now();
+            random::point_cloud_fill(gen, pcl, params, 6 * params.points * f);
+            t_generate += seconds_since(start);
+
+            // rotates the normals channels as well
+            start = Clock::now();
+            pcl_base = T * pcl;
+            t_transform += seconds_since(start);
+        }
+    }
+
+    const size_t messages = sensors * frames;
+    const size_t points = messages * params.points;
+    std::cout << "PointCloud (" << params.points << " points with normals)" << std::endl;
+    report("generate", messages, points, t_generate);
+    report("TransformStamped * PointCloud", messages, points, t_transform);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t sensors = (argc > 1) ? std::stoul(argv[1]) : 8;
+    const size_t frames = (argc > 2) ? std::stoul(argv[2]) : 100;
+
+    std::cout << "Benchmark of sensor_msgs paths: "
+        << sensors << " sensors x " << frames << " frames" << std::endl;
+
+    benchmark_laser_scans(sensors, frames);
+    benchmark_point_clouds(sensors, frames);
+
+    return 0;
+}
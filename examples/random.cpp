@@ -54,7 +54,14 @@ void random_simple()
     ROS_INFO_STREAM(st.mean);
     ROS_INFO_STREAM(st.variance);
 
-    pca(points);
+    PCA pc = pca(points);
+
+    std::cout << "Principal Components:" << std::endl;
+    for(int i=2; i>=0; i--)
+    {
+        std::cout << "-- " << pc.eigenvectors.col(i).transpose() 
+                  << ": " << pc.eigenvalues(i) << std::endl;
+    }
 }
 
 void normal_sampling_fits()
@@ -2,6 +2,11 @@
 #define ROSMATH_EIGEN_HPP
 
 #include "eigen/conversions.h"
+#include "eigen/gmm.h"
+#include "eigen/kalman.h"
+#include "eigen/map.h"
+#include "eigen/ndt.h"
+#include "eigen/ransac.h"
 #include "eigen/stats.h"
 
 #endif // ROSMATH_EIGEN_HPP
\ No newline at end of file
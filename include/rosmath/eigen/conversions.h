@@ -2,10 +2,19 @@
 #define ROSMATH_EIGEN_CONVERSIONS_H
 
 #include "rosmath/conversions.h"
+#include <nav_msgs/Path.h>
 #include <Eigen/Dense>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+#include <vector>
 
 namespace rosmath {
 
+using Isometry3dVector = std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d> >;
+
+// poses as columns (x, y, z, qx, qy, qz, qw)
+using Matrix7Xd = Eigen::Matrix<double, 7, Eigen::Dynamic>;
+
 ///////////////////////////////////////////
 //
 // CONVERSION FUNCTIONS
@@ -132,6 +141,54 @@ void convert(   const std::vector<double>& from,
 void convert(   const std::vector<double>& from, 
                 Eigen::VectorXd& to);
 
+// CONTAINERS
+// one column per element. the matrices and vectors are resized
+void convert(   const std::vector<geometry_msgs::Point>& from,
+                Eigen::Matrix3Xd& to);
+
+void convert(   const std::vector<geometry_msgs::Point>& from,
+                Eigen::Matrix3Xf& to);
+
+void convert(   const Eigen::Matrix3Xd& from,
+                std::vector<geometry_msgs::Point>& to);
+
+void convert(   const Eigen::Matrix3Xf& from,
+                std::vector<geometry_msgs::Point>& to);
+
+void convert(   const std::vector<geometry_msgs::Point32>& from,
+                Eigen::Matrix3Xf& to);
+
+void convert(   const std::vector<geometry_msgs::Point32>& from,
+                Eigen::Matrix3Xd& to);
+
+void convert(   const Eigen::Matrix3Xf& from,
+                std::vector<geometry_msgs::Point32>& to);
+
+void convert(   const Eigen::Matrix3Xd& from,
+                std::vector<geometry_msgs::Point32>& to);
+
+void convert(   const std::vector<geometry_msgs::Pose>& from,
+                Isometry3dVector& to);
+
+void convert(   const Isometry3dVector& from,
+                std::vector<geometry_msgs::Pose>& to);
+
+void convert(   const std::vector<geometry_msgs::Pose>& from,
+                Matrix7Xd& to);
+
+void convert(   const Matrix7Xd& from,
+                std::vector<geometry_msgs::Pose>& to);
+
+void convert(   const nav_msgs::Path& from,
+                Isometry3dVector& to);
+
+void convert(   const nav_msgs::Path& from,
+                Matrix7Xd& to);
+
+// keeps the header of the path and of existing poses
+void convert(   const Matrix7Xd& from,
+                nav_msgs::Path& to);
+
 ///////////////////////////////////////////
 //
 // CONVERSION OPERATOR: 
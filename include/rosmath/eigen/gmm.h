@@ -0,0 +1,107 @@
+#ifndef ROSMATH_EIGEN_GMM_H
+#define ROSMATH_EIGEN_GMM_H
+
+#include <rosmath/eigen/stats.h>
+#include <sensor_msgs/PointCloud.h>
+#include <Eigen/Dense>
+#include <vector>
+
+namespace rosmath {
+
+namespace stats {
+
+/**
+ * @brief Gaussian Mixture Model
+ * 
+ * p(x) = sum_k w_k * N_k(x)
+ * 
+ * Samples are passed as MatrixXd. rows: dim, cols: N samples
+ * 
+ * Fitting uses k-means++ initialization followed by 
+ * Expectation-Maximization. Responsibilities are computed in log space 
+ * (log-sum-exp) and in parallel over samples if OpenMP is available.
+ */
+class GaussianMixture {
+public:
+    GaussianMixture();
+
+    GaussianMixture(
+        const std::vector<double>& weights,
+        const std::vector<Normal>& components);
+
+    // number of components
+    size_t size() const;
+    size_t dim() const;
+
+    const std::vector<double>& weights() const;
+    const std::vector<Normal>& components() const;
+
+    double pdf(const Eigen::VectorXd& X) const;
+    double logpdf(const Eigen::VectorXd& X) const;
+
+    Eigen::VectorXd pdf(const Eigen::MatrixXd& X, bool parallel = false) const;
+    Eigen::VectorXd logpdf(const Eigen::MatrixXd& X, bool parallel = false) const;
+
+    /**
+     * Posterior probability of each component for each sample
+     * 
+     * returns MatrixXd. rows: N samples, cols: components
+     */
+    Eigen::MatrixXd responsibilities(const Eigen::MatrixXd& X, bool parallel = false) const;
+
+    // most likely component
+    size_t predict(const Eigen::VectorXd& X) const;
+    std::vector<size_t> predict(const Eigen::MatrixXd& X, bool parallel = false) const;
+
+    Eigen::VectorXd sample() const;
+
+    /**
+     * samples
+     * 
+     * returns MatrixXd. rows: dim, cols: N
+     */
+    Eigen::MatrixXd samples(size_t N) const;
+
+    /**
+     * Fit K components to X data with EM
+     * 
+     * @param sX samples. rows: dim, cols: N
+     * @param K number of components
+     * @param max_iterations maximum number of EM iterations
+     * @param tolerance stop if the relative change of the log-likelihood is smaller
+     * @param regularization added to the covariance diagonals to keep them positive definite
+     */
+    static GaussianMixture fit(
+        const Eigen::MatrixXd& sX, 
+        const size_t K,
+        const size_t max_iterations = 100,
+        const double tolerance = 1e-6,
+        const double regularization = 1e-6);
+
+    static GaussianMixture fit(
+        const std::vector<geometry_msgs::Point>& points,
+        const size_t K,
+        const size_t max_iterations = 100,
+        const double tolerance = 1e-6,
+        const double regularization = 1e-6);
+
+    static GaussianMixture fit(
+        const sensor_msgs::PointCloud& pcl,
+        const size_t K,
+        const size_t max_iterations = 100,
+        const double tolerance = 1e-6,
+        const double regularization = 1e-6);
+
+private:
+    // log(w_k) + log(N_k(x_i)). rows: N samples, cols: components
+    Eigen::MatrixXd weightedLogLikelihoods(const Eigen::MatrixXd& X, bool parallel) const;
+
+    std::vector<double> m_weights;
+    std::vector<Normal> m_components;
+};
+
+} // namespace stats
+
+} // namespace rosmath
+
+#endif // ROSMATH_EIGEN_GMM_H
@@ -0,0 +1,151 @@
+#ifndef ROSMATH_EIGEN_KALMAN_H
+#define ROSMATH_EIGEN_KALMAN_H
+
+#include <rosmath/eigen/stats.h>
+#include <Eigen/Dense>
+#include <vector>
+
+namespace rosmath {
+
+namespace stats {
+
+/**
+ * @brief Linear / Extended Kalman Filter
+ * 
+ * State and covariance are fixed-size for StateDim != Eigen::Dynamic,
+ * so predict and update steps do not allocate. Measurement dimensions 
+ * are deduced from the passed matrices.
+ * 
+ * The covariance update uses the Joseph form 
+ * P = (I - K*H) * P * (I - K*H)^T + K * R * K^T
+ * which keeps P symmetric positive semi-definite.
+ * 
+ * Extended variants take the nonlinear function and its Jacobian 
+ * evaluated at the current state.
+ */
+template<int StateDim>
+class KalmanFilter_ {
+public:
+    using State = Eigen::Matrix<double, StateDim, 1>;
+    using Covariance = Eigen::Matrix<double, StateDim, StateDim>;
+
+    template<int MeasDim>
+    using Measurement = Eigen::Matrix<double, MeasDim, 1>;
+    template<int MeasDim>
+    using MeasurementModel = Eigen::Matrix<double, MeasDim, StateDim>;
+    template<int MeasDim>
+    using MeasurementCovariance = Eigen::Matrix<double, MeasDim, MeasDim>;
+
+    KalmanFilter_(const State& x, const Covariance& P);
+    KalmanFilter_(const Normal_<StateDim>& N);
+
+    size_t dim() const;
+
+    const State& state() const;
+    const Covariance& covariance() const;
+    Normal_<StateDim> normal() const;
+
+    void reset(const State& x, const Covariance& P);
+    void reset(const Normal_<StateDim>& N);
+
+    /**
+     * x = F * x
+     * P = F * P * F^T + Q
+     */
+    void predict(const Covariance& F, const Covariance& Q);
+
+    /**
+     * x = F * x + B * u
+     * P = F * P * F^T + Q
+     */
+    template<int ControlDim>
+    void predict(
+        const Covariance& F, 
+        const Eigen::Matrix<double, StateDim, ControlDim>& B,
+        const Eigen::Matrix<double, ControlDim, 1>& u,
+        const Covariance& Q);
+
+    /**
+     * Extended: x = f(x), P = F * P * F^T + Q
+     * 
+     * F: Jacobian of f at the current state
+     */
+    template<typename Function>
+    void predict(Function f, const Covariance& F, const Covariance& Q);
+
+    /**
+     * z = H * x + v, v ~ N(0, R)
+     */
+    template<int MeasDim>
+    void update(
+        const Measurement<MeasDim>& z, 
+        const MeasurementModel<MeasDim>& H,
+        const MeasurementCovariance<MeasDim>& R);
+
+    /**
+     * z ~ Z, z = H * x
+     * 
+     * H is not used for deduction, so expressions like Identity() work
+     */
+    template<int MeasDim>
+    void update(
+        const Normal_<MeasDim>& Z, 
+        const MeasurementModel<Normal_<MeasDim>::Dimension>& H);
+
+    /**
+     * Extended: z = h(x) + v, v ~ N(0, R)
+     * 
+     * H: Jacobian of h at the current state
+     */
+    template<int MeasDim, typename Function>
+    void update(
+        const Measurement<MeasDim>& z, 
+        Function h,
+        const MeasurementModel<MeasDim>& H,
+        const MeasurementCovariance<MeasDim>& R);
+
+    /**
+     * Sequential updates with independent measurements of the same model
+     */
+    template<int MeasDim>
+    void update(
+        const std::vector<Normal_<MeasDim> >& Zs, 
+        const MeasurementModel<Normal_<MeasDim>::Dimension>& H);
+
+    /**
+     * Pose and twist measurements. H maps the state to the Normal6 layout
+     * (see convert). Angle residuals of poses are wrapped to [-pi, pi].
+     */
+    void update(
+        const geometry_msgs::PoseWithCovariance& z,
+        const MeasurementModel<6>& H);
+
+    void update(
+        const geometry_msgs::TwistWithCovariance& z,
+        const MeasurementModel<6>& H);
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+    // innovation y = z - h(x)
+    template<int MeasDim>
+    void correct(
+        const Measurement<MeasDim>& y, 
+        const MeasurementModel<MeasDim>& H,
+        const MeasurementCovariance<MeasDim>& R);
+
+    State m_x;
+    Covariance m_P;
+};
+
+using KalmanFilter = KalmanFilter_<Eigen::Dynamic>;
+using KalmanFilter6 = KalmanFilter_<6>;
+using KalmanFilter12 = KalmanFilter_<12>;
+
+} // namespace stats
+
+} // namespace rosmath
+
+#include "kalman.tcc"
+
+#endif // ROSMATH_EIGEN_KALMAN_H
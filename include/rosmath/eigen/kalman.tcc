@@ -0,0 +1,184 @@
+namespace rosmath {
+
+namespace stats {
+
+template<int StateDim>
+KalmanFilter_<StateDim>::KalmanFilter_(const State& x, const Covariance& P)
+:m_x(x)
+,m_P(P)
+{
+
+}
+
+template<int StateDim>
+KalmanFilter_<StateDim>::KalmanFilter_(const Normal_<StateDim>& N)
+:m_x(N.mean())
+,m_P(N.cov())
+{
+
+}
+
+template<int StateDim>
+size_t KalmanFilter_<StateDim>::dim() const
+{
+    return m_x.rows();
+}
+
+template<int StateDim>
+const typename KalmanFilter_<StateDim>::State& KalmanFilter_<StateDim>::state() const
+{
+    return m_x;
+}
+
+template<int StateDim>
+const typename KalmanFilter_<StateDim>::Covariance& KalmanFilter_<StateDim>::covariance() const
+{
+    return m_P;
+}
+
+template<int StateDim>
+Normal_<StateDim> KalmanFilter_<StateDim>::normal() const
+{
+    return Normal_<StateDim>(m_x, m_P);
+}
+
+template<int StateDim>
+void KalmanFilter_<StateDim>::reset(const State& x, const Covariance& P)
+{
+    m_x = x;
+    m_P = P;
+}
+
+template<int StateDim>
+void KalmanFilter_<StateDim>::reset(const Normal_<StateDim>& N)
+{
+    reset(N.mean(), N.cov());
+}
+
+template<int StateDim>
+void KalmanFilter_<StateDim>::predict(const Covariance& F, const Covariance& Q)
+{
+    m_x = F * m_x;
+    m_P = F * m_P * F.transpose() + Q;
+}
+
+template<int StateDim>
+template<int ControlDim>
+void KalmanFilter_<StateDim>::predict(
+    const Covariance& F, 
+    const Eigen::Matrix<double, StateDim, ControlDim>& B,
+    const Eigen::Matrix<double, ControlDim, 1>& u,
+    const Covariance& Q)
+{
+    m_x = F * m_x + B * u;
+    m_P = F * m_P * F.transpose() + Q;
+}
+
+template<int StateDim>
+template<typename Function>
+void KalmanFilter_<StateDim>::predict(Function f, const Covariance& F, const Covariance& Q)
+{
+    m_x = f(m_x);
+    m_P = F * m_P * F.transpose() + Q;
+}
+
+template<int StateDim>
+template<int MeasDim>
+void KalmanFilter_<StateDim>::correct(
+    const Measurement<MeasDim>& y, 
+    const MeasurementModel<MeasDim>& H,
+    const MeasurementCovariance<MeasDim>& R)
+{
+    // S = H * P * H^T + R
+    // K = P * H^T * S^-1 = (S^-1 * H * P)^T
+    const Eigen::Matrix<double, StateDim, MeasDim> PHt = m_P * H.transpose();
+    const MeasurementCovariance<MeasDim> S = H * PHt + R;
+
+    const Eigen::LLT<MeasurementCovariance<MeasDim> > llt(S);
+    if(llt.info() != Eigen::Success)
+    {
+        throw std::runtime_error("KalmanFilter: innovation covariance is not positive definite");
+    }
+
+    const Eigen::Matrix<double, StateDim, MeasDim> K = llt.solve(PHt.transpose()).transpose();
+
+    m_x += K * y;
+
+    // Joseph form
+    Covariance IKH = -K * H;
+    IKH.diagonal().array() += 1.0;
+    m_P = IKH * m_P * IKH.transpose() + K * R * K.transpose();
+}
+
+template<int StateDim>
+template<int MeasDim>
+void KalmanFilter_<StateDim>::update(
+    const Measurement<MeasDim>& z, 
+    const MeasurementModel<MeasDim>& H,
+    const MeasurementCovariance<MeasDim>& R)
+{
+    correct<MeasDim>(z - H * m_x, H, R);
+}
+
+template<int StateDim>
+template<int MeasDim>
+void KalmanFilter_<StateDim>::update(
+    const Normal_<MeasDim>& Z, 
+    const MeasurementModel<Normal_<MeasDim>::Dimension>& H)
+{
+    update<MeasDim>(Z.mean(), H, Z.cov());
+}
+
+template<int StateDim>
+template<int MeasDim, typename Function>
+void KalmanFilter_<StateDim>::update(
+    const Measurement<MeasDim>& z, 
+    Function h,
+    const MeasurementModel<MeasDim>& H,
+    const MeasurementCovariance<MeasDim>& R)
+{
+    correct<MeasDim>(z - h(m_x), H, R);
+}
+
+template<int StateDim>
+template<int MeasDim>
+void KalmanFilter_<StateDim>::update(
+    const std::vector<Normal_<MeasDim> >& Zs, 
+    const MeasurementModel<Normal_<MeasDim>::Dimension>& H)
+{
+    for(const Normal_<MeasDim>& Z : Zs)
+    {
+        update<MeasDim>(Z.mean(), H, Z.cov());
+    }
+}
+
+template<int StateDim>
+void KalmanFilter_<StateDim>::update(
+    const geometry_msgs::PoseWithCovariance& z,
+    const MeasurementModel<6>& H)
+{
+    Normal6 Z;
+    convert(z, Z);
+
+    Measurement<6> y = Z.mean() - H * m_x;
+    for(size_t i=3; i<6; i++)
+    {
+        y(i) = std::atan2(std::sin(y(i)), std::cos(y(i)));
+    }
+
+    correct<6>(y, H, Z.cov());
+}
+
+template<int StateDim>
+void KalmanFilter_<StateDim>::update(
+    const geometry_msgs::TwistWithCovariance& z,
+    const MeasurementModel<6>& H)
+{
+    Normal6 Z;
+    convert(z, Z);
+    update<6>(Z.mean(), H, Z.cov());
+}
+
+} // namespace stats
+
+} // namespace rosmath
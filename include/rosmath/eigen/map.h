@@ -0,0 +1,96 @@
+#ifndef ROSMATH_EIGEN_MAP_H
+#define ROSMATH_EIGEN_MAP_H
+
+#include <geometry_msgs/Point.h>
+#include <geometry_msgs/Point32.h>
+#include <sensor_msgs/PointCloud.h>
+#include <boost/array.hpp>
+#include <Eigen/Dense>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace rosmath {
+
+///////////////////////////////////////////
+//
+// EIGEN MAPS
+// views on message memory, no copies.
+// writes through a map change the message
+//
+/////////////
+
+// one point per row
+using PointsMap = Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> >;
+using ConstPointsMap = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> >;
+using Points32Map = Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> >;
+using ConstPoints32Map = Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> >;
+
+// 6x6 covariances of PoseWithCovariance, TwistWithCovariance, ...
+using CovarianceMap = Eigen::Map<Eigen::Matrix<double, 6, 6, Eigen::RowMajor> >;
+using ConstCovarianceMap = Eigen::Map<const Eigen::Matrix<double, 6, 6, Eigen::RowMajor> >;
+
+// the maps require the messages to be packed xyz
+static_assert(std::is_standard_layout<geometry_msgs::Point>::value
+    && sizeof(geometry_msgs::Point) == 3 * sizeof(double)
+    && offsetof(geometry_msgs::Point, x) == 0
+    && offsetof(geometry_msgs::Point, y) == sizeof(double)
+    && offsetof(geometry_msgs::Point, z) == 2 * sizeof(double),
+    "geometry_msgs::Point is not three packed doubles");
+
+static_assert(std::is_standard_layout<geometry_msgs::Point32>::value
+    && sizeof(geometry_msgs::Point32) == 3 * sizeof(float)
+    && offsetof(geometry_msgs::Point32, x) == 0
+    && offsetof(geometry_msgs::Point32, y) == sizeof(float)
+    && offsetof(geometry_msgs::Point32, z) == 2 * sizeof(float),
+    "geometry_msgs::Point32 is not three packed floats");
+
+static_assert(sizeof(boost::array<double, 36>) == 36 * sizeof(double),
+    "boost::array<double, 36> is not 36 packed doubles");
+
+// N x 3
+inline PointsMap eigen_map(std::vector<geometry_msgs::Point>& points)
+{
+    return PointsMap(reinterpret_cast<double*>(points.data()), points.size(), 3);
+}
+
+inline ConstPointsMap eigen_map(const std::vector<geometry_msgs::Point>& points)
+{
+    return ConstPointsMap(reinterpret_cast<const double*>(points.data()), points.size(), 3);
+}
+
+inline Points32Map eigen_map(std::vector<geometry_msgs::Point32>& points)
+{
+    return Points32Map(reinterpret_cast<float*>(points.data()), points.size(), 3);
+}
+
+inline ConstPoints32Map eigen_map(const std::vector<geometry_msgs::Point32>& points)
+{
+    return ConstPoints32Map(reinterpret_cast<const float*>(points.data()), points.size(), 3);
+}
+
+// points of the cloud, channels are not mapped
+inline Points32Map eigen_map(sensor_msgs::PointCloud& cloud)
+{
+    return eigen_map(cloud.points);
+}
+
+inline ConstPoints32Map eigen_map(const sensor_msgs::PointCloud& cloud)
+{
+    return eigen_map(cloud.points);
+}
+
+// row-major as in the messages
+inline CovarianceMap eigen_map(boost::array<double, 36>& covariance)
+{
+    return CovarianceMap(covariance.data());
+}
+
+inline ConstCovarianceMap eigen_map(const boost::array<double, 36>& covariance)
+{
+    return ConstCovarianceMap(covariance.data());
+}
+
+} // namespace rosmath
+
+#endif // ROSMATH_EIGEN_MAP_H
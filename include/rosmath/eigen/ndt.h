@@ -0,0 +1,114 @@
+#ifndef ROSMATH_EIGEN_NDT_H
+#define ROSMATH_EIGEN_NDT_H
+
+#include <rosmath/eigen/stats.h>
+#include <sensor_msgs/PointCloud.h>
+#include <Eigen/Dense>
+#include <unordered_map>
+#include <vector>
+
+namespace rosmath {
+
+namespace stats {
+
+/**
+ * @brief Normal Distributions Transform (NDT) voxel map
+ * 
+ * Points are accumulated per voxel (count, mean, scatter matrix). 
+ * Accumulators are mergeable, so clouds can be inserted incrementally 
+ * and in parallel: each thread fills its own voxel table, the tables are 
+ * merged afterwards. Every voxel with at least min_points points holds 
+ * a Normal3. Small eigenvalues of its covariance are clamped to keep 
+ * planar and linear voxels invertible.
+ * 
+ * Scores of a query cloud under a 6-DOF transform 
+ * x = (x, y, z, roll, pitch, yaw), R = Rz(yaw) * Ry(pitch) * Rx(roll):
+ * 
+ * score(x) = sum_i exp(-0.5 * q_i^T * cov_i^-1 * q_i), q_i = T(x) * p_i - mean_i
+ * 
+ * Higher is better. The analytic gradient w.r.t. x is available for 
+ * gradient based registration.
+ * 
+ * source: Magnusson, "The Three-Dimensional Normal-Distributions Transform", 2009
+ */
+class NDTMap {
+public:
+    using Vector6 = Eigen::Matrix<double, 6, 1>;
+
+    NDTMap(double resolution, size_t min_points = 5);
+
+    double resolution() const;
+
+    // number of voxels with a valid distribution
+    size_t size() const;
+    void clear();
+
+    // parallel insertion (OpenMP). Points: rows: 3, cols: N
+    void insert(const Eigen::Matrix3Xd& points);
+    void insert(const std::vector<geometry_msgs::Point>& points);
+    void insert(const sensor_msgs::PointCloud& cloud);
+
+    /**
+     * Distribution of the voxel containing p
+     * 
+     * returns nullptr if the voxel has less than min_points points
+     */
+    const Normal3* cell(const Eigen::Vector3d& p) const;
+
+    // all valid distributions
+    std::vector<Normal3> cells() const;
+
+    /**
+     * Score of the query points transformed by x
+     * 
+     * @param gradient if not nullptr: d score / d x
+     */
+    double score(
+        const Eigen::Matrix3Xd& points, 
+        const Vector6& x,
+        Vector6* gradient = nullptr) const;
+
+    double score(
+        const sensor_msgs::PointCloud& cloud, 
+        const Vector6& x,
+        Vector6* gradient = nullptr) const;
+
+    // without gradient
+    double score(
+        const sensor_msgs::PointCloud& cloud, 
+        const geometry_msgs::Transform& T) const;
+
+    double score(
+        const sensor_msgs::PointCloud& cloud, 
+        const geometry_msgs::Pose& T) const;
+
+private:
+    struct Cell {
+        size_t count = 0;
+        Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+        // sum (p - mean) * (p - mean)^T
+        Eigen::Matrix3d scatter = Eigen::Matrix3d::Zero();
+        bool valid = false;
+        bool dirty = false;
+        Normal3 normal;
+
+        void add(const Eigen::Vector3d& p);
+        void merge(const Cell& other);
+    };
+
+    using Table = std::unordered_map<int64_t, Cell>;
+
+    int64_t key(const Eigen::Vector3d& p) const;
+    void finalize(Cell& cell) const;
+
+    double m_resolution;
+    size_t m_min_points;
+    size_t m_valid;
+    Table m_cells;
+};
+
+} // namespace stats
+
+} // namespace rosmath
+
+#endif // ROSMATH_EIGEN_NDT_H
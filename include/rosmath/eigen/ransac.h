@@ -0,0 +1,185 @@
+#ifndef ROSMATH_EIGEN_RANSAC_H
+#define ROSMATH_EIGEN_RANSAC_H
+
+#include <geometry_msgs/Point.h>
+#include <sensor_msgs/PointCloud.h>
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// internal deps
+#include "rosmath/random/philox.h"
+
+namespace rosmath {
+
+namespace stats {
+
+enum class RansacScore {
+    // number of inliers
+    RANSAC,
+    // truncated quadratic cost sum(min(e^2, t^2)), prefers tighter fits
+    MSAC
+};
+
+struct RansacParams {
+    // inlier distance
+    double threshold = 0.05;
+    // probability of drawing at least one all-inlier sample
+    double confidence = 0.99;
+    size_t max_iterations = 1000;
+    RansacScore score = RansacScore::MSAC;
+    // least squares fit to the inliers of the best hypothesis
+    bool refine = true;
+    uint64_t seed = 0;
+};
+
+template<typename Model>
+struct RansacResult {
+    Model model;
+    std::vector<size_t> inliers;
+    // evaluated hypotheses
+    size_t iterations = 0;
+    // cost of the returned model (lower is better)
+    double cost = 0.0;
+    bool success = false;
+};
+
+/**
+ * Number of iterations to draw at least one all-inlier sample of
+ * sample_size elements with probability confidence
+ */
+size_t ransac_iterations(
+    const double confidence,
+    const double inlier_ratio,
+    const size_t sample_size);
+
+/**
+ * @brief Generic RANSAC/MSAC with pluggable minimal solvers
+ *
+ * Hypotheses are drawn and scored in batches in parallel (OpenMP).
+ * Hypothesis h samples from its own Philox stream (seed, h), so results
+ * are reproducible and independent of the number of threads. Scoring of
+ * a hypothesis stops as soon as its cost exceeds the best cost of the
+ * previous batches. The number of iterations adapts to the best inlier
+ * ratio w: log(1 - confidence) / log(1 - w^SAMPLE_SIZE).
+ *
+ * Solver interface:
+ *
+ *   using Model = ...;
+ *   static constexpr size_t SAMPLE_SIZE = ...;
+ *   size_t size() const;                              // number of data elements
+ *   bool fit(const std::array<size_t, SAMPLE_SIZE>& sample, Model& model) const;
+ *   double error(const Model& model, size_t i) const; // residual distance of element i
+ *   bool refine(const std::vector<size_t>& inliers, Model& model) const;
+ *
+ * fit and refine return false for degenerate input.
+ *
+ * source: Torr, Zisserman - "MLESAC: A new robust estimator with application
+ *   to estimating image geometry", CVIU 2000
+ */
+template<typename Solver>
+RansacResult<typename Solver::Model> ransac(
+    const Solver& solver,
+    const RansacParams& params = RansacParams());
+
+/**
+ * Plane n^T p + d = 0, |n| = 1. Refined with the PCA of the inliers.
+ */
+class PlaneSolver {
+public:
+    using Model = Eigen::Hyperplane<double, 3>;
+    static constexpr size_t SAMPLE_SIZE = 3;
+
+    PlaneSolver(const Eigen::Matrix3Xd& points);
+    PlaneSolver(const std::vector<geometry_msgs::Point>& points);
+    PlaneSolver(const sensor_msgs::PointCloud& cloud);
+
+    size_t size() const;
+    bool fit(const std::array<size_t, SAMPLE_SIZE>& sample, Model& model) const;
+    double error(const Model& model, size_t i) const;
+    bool refine(const std::vector<size_t>& inliers, Model& model) const;
+
+private:
+    Eigen::Matrix3Xd m_points;
+};
+
+/**
+ * Line through origin() with unit direction(). Refined with the PCA
+ * of the inliers.
+ */
+class LineSolver {
+public:
+    using Model = Eigen::ParametrizedLine<double, 3>;
+    static constexpr size_t SAMPLE_SIZE = 2;
+
+    LineSolver(const Eigen::Matrix3Xd& points);
+    LineSolver(const std::vector<geometry_msgs::Point>& points);
+    LineSolver(const sensor_msgs::PointCloud& cloud);
+
+    size_t size() const;
+    bool fit(const std::array<size_t, SAMPLE_SIZE>& sample, Model& model) const;
+    double error(const Model& model, size_t i) const;
+    bool refine(const std::vector<size_t>& inliers, Model& model) const;
+
+private:
+    Eigen::Matrix3Xd m_points;
+};
+
+/**
+ * Rigid transform T with target_i = T * source_i from point
+ * correspondences. Minimal and refined solutions with Umeyama
+ * (without scaling).
+ */
+class RigidSolver {
+public:
+    using Model = Eigen::Isometry3d;
+    static constexpr size_t SAMPLE_SIZE = 3;
+
+    RigidSolver(const Eigen::Matrix3Xd& source, const Eigen::Matrix3Xd& target);
+    RigidSolver(
+        const std::vector<geometry_msgs::Point>& source,
+        const std::vector<geometry_msgs::Point>& target);
+
+    size_t size() const;
+    bool fit(const std::array<size_t, SAMPLE_SIZE>& sample, Model& model) const;
+    double error(const Model& model, size_t i) const;
+    bool refine(const std::vector<size_t>& inliers, Model& model) const;
+
+private:
+    Eigen::Matrix3Xd m_source;
+    Eigen::Matrix3Xd m_target;
+};
+
+// shortcuts
+RansacResult<PlaneSolver::Model> ransac_plane(
+    const std::vector<geometry_msgs::Point>& points,
+    const RansacParams& params = RansacParams());
+
+RansacResult<PlaneSolver::Model> ransac_plane(
+    const sensor_msgs::PointCloud& cloud,
+    const RansacParams& params = RansacParams());
+
+RansacResult<LineSolver::Model> ransac_line(
+    const std::vector<geometry_msgs::Point>& points,
+    const RansacParams& params = RansacParams());
+
+RansacResult<LineSolver::Model> ransac_line(
+    const sensor_msgs::PointCloud& cloud,
+    const RansacParams& params = RansacParams());
+
+RansacResult<RigidSolver::Model> ransac_rigid(
+    const std::vector<geometry_msgs::Point>& source,
+    const std::vector<geometry_msgs::Point>& target,
+    const RansacParams& params = RansacParams());
+
+} // namespace stats
+
+} // namespace rosmath
+
+#include "ransac.tcc"
+
+#endif // ROSMATH_EIGEN_RANSAC_H
@@ -0,0 +1,181 @@
+namespace rosmath {
+
+namespace stats {
+
+namespace detail {
+
+// distinct indices in [0, n) from the stream of gen
+template<size_t S>
+bool ransac_sample(random::Philox& gen, const size_t n, std::array<size_t, S>& sample)
+{
+    // retries for duplicates before the hypothesis is skipped
+    constexpr size_t MAX_TRIES = 32;
+
+    for(size_t k=0; k<S; k++)
+    {
+        bool duplicate = true;
+        for(size_t t=0; t<MAX_TRIES && duplicate; t++)
+        {
+            const uint64_t x = (static_cast<uint64_t>(gen()) << 32) | gen();
+            sample[k] = static_cast<size_t>(random::mul_hi(x, n));
+            duplicate = std::find(sample.begin(), sample.begin() + k, sample[k]) != sample.begin() + k;
+        }
+        if(duplicate)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// cost of model, stops as soon as it exceeds bound
+template<typename Solver>
+double ransac_cost(const Solver& solver, const typename Solver::Model& model,
+    const double t2, const bool msac, const double bound, size_t& n_inliers)
+{
+    double cost = 0.0;
+    n_inliers = 0;
+    for(size_t i=0; i<solver.size() && cost <= bound; i++)
+    {
+        const double e = solver.error(model, i);
+        const double e2 = e * e;
+        if(e2 < t2)
+        {
+            n_inliers++;
+            cost += msac ? e2 : 0.0;
+        } else {
+            cost += t2;
+        }
+    }
+    return cost;
+}
+
+template<typename Solver>
+double ransac_inliers(const Solver& solver, const typename Solver::Model& model,
+    const double t2, const bool msac, std::vector<size_t>& inliers)
+{
+    double cost = 0.0;
+    inliers.clear();
+    for(size_t i=0; i<solver.size(); i++)
+    {
+        const double e = solver.error(model, i);
+        const double e2 = e * e;
+        if(e2 < t2)
+        {
+            inliers.push_back(i);
+            cost += msac ? e2 : 0.0;
+        } else {
+            cost += t2;
+        }
+    }
+    return cost;
+}
+
+} // namespace detail
+
+template<typename Solver>
+RansacResult<typename Solver::Model> ransac(
+    const Solver& solver,
+    const RansacParams& params)
+{
+    using Model = typename Solver::Model;
+    constexpr size_t S = Solver::SAMPLE_SIZE;
+    // hypotheses per parallel batch
+    constexpr size_t BATCH = 64;
+
+    RansacResult<Model> result;
+    const size_t n = solver.size();
+    if(n < S)
+    {
+        return result;
+    }
+
+    const double t2 = params.threshold * params.threshold;
+    const bool msac = (params.score == RansacScore::MSAC);
+
+    Model best_model;
+    double best_cost = std::numeric_limits<double>::infinity();
+    size_t best_inliers = 0;
+    uint64_t best_h = std::numeric_limits<uint64_t>::max();
+
+    size_t required = params.max_iterations;
+    size_t h0 = 0;
+    while(h0 < required)
+    {
+        const int64_t batch = std::min(BATCH, required - h0);
+        // bound of the previous batches: preemption does not depend on timing
+        const double bound = best_cost;
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(int64_t b=0; b<batch; b++)
+        {
+            const uint64_t h = h0 + b;
+            random::Philox gen(params.seed, h);
+
+            std::array<size_t, S> sample;
+            Model model;
+            if(!detail::ransac_sample(gen, n, sample) || !solver.fit(sample, model))
+            {
+                continue;
+            }
+
+            size_t n_inliers;
+            const double cost = detail::ransac_cost(solver, model, t2, msac, bound, n_inliers);
+            if(cost > bound)
+            {
+                continue;
+            }
+
+            #pragma omp critical(rosmath_ransac)
+            {
+                if(cost < best_cost || (cost == best_cost && h < best_h))
+                {
+                    best_model = model;
+                    best_cost = cost;
+                    best_inliers = n_inliers;
+                    best_h = h;
+                }
+            }
+        }
+
+        h0 += batch;
+
+        if(best_inliers > 0)
+        {
+            required = std::min(params.max_iterations, ransac_iterations(
+                params.confidence, static_cast<double>(best_inliers) / n, S));
+        }
+    }
+
+    result.iterations = h0;
+    if(best_inliers == 0)
+    {
+        return result;
+    }
+
+    result.model = best_model;
+    result.cost = detail::ransac_inliers(solver, best_model, t2, msac, result.inliers);
+    result.success = true;
+
+    if(params.refine && result.inliers.size() > S)
+    {
+        Model refined = best_model;
+        std::vector<size_t> refined_inliers;
+        if(solver.refine(result.inliers, refined))
+        {
+            const double cost = detail::ransac_inliers(solver, refined, t2, msac, refined_inliers);
+            if(cost <= result.cost)
+            {
+                result.model = refined;
+                result.cost = cost;
+                result.inliers.swap(refined_inliers);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace stats
+
+} // namespace rosmath
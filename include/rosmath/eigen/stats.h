@@ -2,7 +2,11 @@
 #define ROSMATH_EIGEN_STATS_H
 
 #include <rosmath/random.h>
+#include <rosmath/stats.h>
 #include <Eigen/Dense>
+#include <unsupported/Eigen/MatrixFunctions>
+#include <array>
+#include <exception>
 #include <vector>
 
 namespace rosmath {
@@ -19,11 +23,22 @@ double mahalanobis_dist(
  * 
  * Improved Version of http://blog.sarantop.com/notes/mvn
  * 
+ * The dimension can be fixed at compile time (Normal2, Normal3, Normal6, 
+ * Normal_<N>) to store mean and covariance without heap allocations, 
+ * or dynamic (Normal).
+ * 
+ * Construction only stores mean and covariance. The Cholesky factorization 
+ * (LLT) of the covariance is computed on first use and cached. pdf, logpdf, 
+ * mahalanobisDist, sampling and the (log) determinant are derived from it.
+ * The inverse covariance is cached the same way. The caches are not 
+ * synchronized: call prepare() once before sharing a distribution between 
+ * threads.
+ * 
  * TODO: 
  * - Test class functions for correctness
  * - Implement multivariate fit to X and Y values
  * - Implement some other helpful functions:
- *   - Joint (check), Marginal probability distributions
+ *   - Joint (check) probability distributions
  *   - Mutual Information
  *   - Self Information
  *   - Shannon Entropy
@@ -34,43 +49,104 @@ double mahalanobis_dist(
  *   - Fisher Information (Matrix)
  * 
  */
-class Normal {
+template<int Dim>
+class Normal_ {
 public:
-    Normal(const Eigen::VectorXd& mean, 
-            const Eigen::MatrixXd& cov);
+    using Vector = Eigen::Matrix<double, Dim, 1>;
+    using Matrix = Eigen::Matrix<double, Dim, Dim>;
+    // rows: dim, cols: N
+    using Samples = Eigen::Matrix<double, Dim, Eigen::Dynamic>;
+
+    static constexpr int Dimension = Dim;
+
+    // standard normal for fixed sizes, empty for dynamic size
+    Normal_();
 
-    ~Normal();
+    Normal_(const Vector& mean, 
+            const Matrix& cov);
+
+    // copies the caches only if they are computed
+    Normal_(const Normal_& other);
+    Normal_& operator=(const Normal_& other);
+
+    ~Normal_();
 
     size_t dim() const;
 
-    double mahalanobisDist(const Eigen::VectorXd& X) const;
+    double mahalanobisDist(const Vector& X) const;
 
     // N(X)
-    double pdf(const Eigen::VectorXd& X) const;
+    double pdf(const Vector& X) const;
 
-    Eigen::VectorXd pdf(const Eigen::MatrixXd& X) const;
+    // log(N(X))
+    double logpdf(const Vector& X) const;
 
-    Eigen::VectorXd mean() const;
-    Eigen::MatrixXd cov() const;
-    Eigen::MatrixXd covInv() const;
+    /**
+     * Batch versions for all columns of X (rows: dim, cols: N).
+     * 
+     * All columns are whitened with one triangular solve and the 
+     * normalizer is computed once. With parallel = true, blocks of 
+     * columns are evaluated in parallel (OpenMP).
+     */
+    Eigen::VectorXd mahalanobisDist(const Samples& X, bool parallel = false) const;
+    Eigen::VectorXd pdf(const Samples& X, bool parallel = false) const;
+    Eigen::VectorXd logpdf(const Samples& X, bool parallel = false) const;
+
+    // Dispatch other Eigen types/expressions: column vectors to the 
+    // single sample versions, everything else to the batch versions
+    template<typename Derived, typename std::enable_if<Derived::ColsAtCompileTime == 1, int>::type = 0>
+    double mahalanobisDist(const Eigen::MatrixBase<Derived>& X) const { return mahalanobisDist(Vector(X)); }
+    template<typename Derived, typename std::enable_if<Derived::ColsAtCompileTime == 1, int>::type = 0>
+    double pdf(const Eigen::MatrixBase<Derived>& X) const { return pdf(Vector(X)); }
+    template<typename Derived, typename std::enable_if<Derived::ColsAtCompileTime == 1, int>::type = 0>
+    double logpdf(const Eigen::MatrixBase<Derived>& X) const { return logpdf(Vector(X)); }
+
+    template<typename Derived, typename std::enable_if<Derived::ColsAtCompileTime != 1, int>::type = 0>
+    Eigen::VectorXd mahalanobisDist(const Eigen::MatrixBase<Derived>& X, bool parallel = false) const { return mahalanobisDist(Samples(X), parallel); }
+    template<typename Derived, typename std::enable_if<Derived::ColsAtCompileTime != 1, int>::type = 0>
+    Eigen::VectorXd pdf(const Eigen::MatrixBase<Derived>& X, bool parallel = false) const { return pdf(Samples(X), parallel); }
+    template<typename Derived, typename std::enable_if<Derived::ColsAtCompileTime != 1, int>::type = 0>
+    Eigen::VectorXd logpdf(const Eigen::MatrixBase<Derived>& X, bool parallel = false) const { return logpdf(Samples(X), parallel); }
+
+    const Vector& mean() const;
+    const Matrix& cov() const;
+    const Matrix& covInv() const;
     double covDet() const;
+
+    // log(det(cov)), stable in high dimensions
+    double covLogDet() const;
+
+    /**
+     * Cholesky factorization of the covariance: cov = L * L^T
+     * 
+     * throws std::runtime_error if cov is not positive definite
+     */
+    const Eigen::LLT<Matrix>& llt() const;
+
+    /**
+     * Computes all lazy caches (llt() and covInv()). Afterwards the const
+     * member functions can be called from several threads.
+     * 
+     * throws std::runtime_error if cov is not positive definite
+     */
+    void prepare() const;
     
     // sample
-    Eigen::VectorXd sample() const;
+    Vector sample() const;
 
     /**
      * samples
      * 
-     * returns MatrixXd. rows: dim, cols: N
+     * returns Samples. rows: dim, cols: N
      */
-    Eigen::MatrixXd samples(size_t N) const;
+    Samples samples(size_t N) const;
 
     /**
      * Fit to X data
      * 
-     * sX is a MatrixXd. rows: dim, cols: N samples
+     * sX is a Samples matrix. rows: dim, cols: N samples
      */
-    static Normal fit(const Eigen::MatrixXd& sX);
+    static Normal_ fit(const Samples& sX);
 
     /**
      * Fit to X and Y data
@@ -78,8 +154,8 @@ public:
      * TODO: implement
      * 
      */
-    static Normal fit(
-        const Eigen::MatrixXd& sX, 
+    static Normal_ fit(
+        const Samples& sX, 
         const Eigen::VectorXd& sY);
 
     /**
@@ -90,45 +166,149 @@ public:
      * Is this maybe a bayesian update instead of a joint?
      * 
      */
-    Normal fuse(const Normal& N) const;
+    Normal_ fuse(const Normal_& N) const;
 
     /**
      * x' = T*x
      * Ex' = T*Ex*T.transpose();
      * 
      */
-    Normal transform(const Eigen::MatrixXd& T) const;
+    template<int DimOut>
+    Normal_<DimOut> transform(const Eigen::Matrix<double, DimOut, Dim>& T) const;
 
     /**
      * x' = this->mean() + N.mean()
      * Ex' = this->cov() + N.cov()
      */
-    Normal add(const Normal& N) const;
+    Normal_ add(const Normal_& N) const;
+
+    /**
+     * Marginal distribution of the dimensions in indices (in that order)
+     * 
+     * The std::array version is fixed-size
+     * 
+     * throws std::runtime_error for indices out of range
+     */
+    Normal_<Eigen::Dynamic> marginal(const std::vector<size_t>& indices) const;
+
+    template<int K>
+    Normal_<K> marginal(const std::array<size_t, K>& indices) const;
+
+    /**
+     * Conditional distribution of the remaining dimensions (a) given 
+     * X(indices) = values (b)
+     * 
+     * Uses blocks of the cached precision matrix P = cov^-1:
+     * cov' = P_aa^-1 = cov_aa - cov_ab * cov_bb^-1 * cov_ba (Schur complement)
+     * mean' = mean_a - P_aa^-1 * P_ab * (values - mean_b)
+     * 
+     * The std::array version is fixed-size if Dim is
+     * 
+     * throws std::runtime_error for invalid or duplicate indices
+     */
+    Normal_<Eigen::Dynamic> condition(
+        const std::vector<size_t>& indices, 
+        const Eigen::VectorXd& values) const;
+
+    template<int K>
+    Normal_<(Dim == Eigen::Dynamic ? Eigen::Dynamic : Dim - K)> condition(
+        const std::array<size_t, K>& indices, 
+        const typename Normal_<K>::Vector& values) const;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
 private:
-    Eigen::VectorXd m_mean;
-    Eigen::MatrixXd m_cov;
+    template<int K>
+    Normal_<K> selectMarginal(const Eigen::Matrix<Eigen::Index, K, 1>& indices) const;
+
+    template<int DimA, int DimB>
+    Normal_<DimA> computeCondition(
+        const Eigen::Matrix<Eigen::Index, DimB, 1>& indices, 
+        const Eigen::Matrix<double, DimB, 1>& values) const;
+
+    Vector m_mean;
+    Matrix m_cov;
+
+    // lazily computed
+    mutable Eigen::LLT<Matrix> m_llt;
+    mutable double m_log_det;
+    mutable bool m_factorized;
+
+    mutable Matrix m_cov_inv;
+    mutable bool m_inverted;
+};
+
+using Normal = Normal_<Eigen::Dynamic>;
+using Normal2 = Normal_<2>;
+using Normal3 = Normal_<3>;
+using Normal6 = Normal_<6>;
+
+/**
+ * @brief Multi-way fusion of Gaussians in information form
+ * 
+ * Sums the precision matrices cov_i^-1 and precision-weighted means 
+ * cov_i^-1 * mean_i of all added measurements. The fused distribution is 
+ * computed with a single factorization of the summed precision matrix:
+ * 
+ * cov = (sum cov_i^-1)^-1
+ * mean = cov * sum cov_i^-1 * mean_i
+ * 
+ * Measurements can be added and removed incrementally. Removing 
+ * subtracts the same terms, so remove only what was added before.
+ */
+template<int Dim>
+class InformationFusion_ {
+public:
+    using Vector = typename Normal_<Dim>::Vector;
+    using Matrix = typename Normal_<Dim>::Matrix;
+
+    InformationFusion_();
+
+    void add(const Normal_<Dim>& N);
+    void remove(const Normal_<Dim>& N);
+
+    // number of fused measurements
+    size_t size() const;
+    void clear();
+
+    // sum of precision matrices
+    const Matrix& information() const;
+
+    // sum of precision-weighted means
+    const Vector& informationVector() const;
+
+    Normal_<Dim> normal() const;
 
-    // other
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
-    // PDF
-    Eigen::MatrixXd m_cov_inv;
-    double m_det;
+private:
+    void update(const Normal_<Dim>& N, double sign);
 
-    // Transform for samples
-    Eigen::MatrixXd m_transform;
+    Matrix m_information;
+    Vector m_information_vector;
+    size_t m_size;
 };
 
-Normal fuse(const std::vector<Normal>& Ns);
+using InformationFusion = InformationFusion_<Eigen::Dynamic>;
+using InformationFusion2 = InformationFusion_<2>;
+using InformationFusion3 = InformationFusion_<3>;
+using InformationFusion6 = InformationFusion_<6>;
+
+/**
+ * Fuse all distributions in one pass (information form)
+ */
+template<int Dim>
+Normal_<Dim> fuse(const std::vector<Normal_<Dim> >& Ns);
 
 /**
  * Kullback-Leibler Divergence from N1 to N0
  * or D_KL(N0 || N1)
  * source: https://en.wikipedia.org/wiki/Multivariate_normal_distribution#Kullback%E2%80%93Leibler_divergence
  */
+template<int Dim>
 double kullback_leibler_divergence(
-    const Normal& N0, 
-    const Normal& N1);
+    const Normal_<Dim>& N0, 
+    const Normal_<Dim>& N1);
 
 /**
  * Fisher-Information
@@ -137,9 +317,10 @@ double kullback_leibler_divergence(
  * Fisher(N1 | N2)
  * 
  */
+template<int Dim>
 double fisher_information(
-    const Normal& N1,
-    const Normal& N2);
+    const Normal_<Dim>& N1,
+    const Normal_<Dim>& N2);
 
 /**
  * Wasserstein Information
@@ -148,9 +329,10 @@ double fisher_information(
  * Wasserstein(N1, N2)
  * 
  */
+template<int Dim>
 double wasserstein(
-    const Normal& N1,
-    const Normal& N2);
+    const Normal_<Dim>& N1,
+    const Normal_<Dim>& N2);
 
 /**
  * Hellinger Information
@@ -159,9 +341,10 @@ double wasserstein(
  * Hellinger(N1, N2)
  * 
  */
+template<int Dim>
 double hellinger(
-    const Normal& N1,
-    const Normal& N2);
+    const Normal_<Dim>& N1,
+    const Normal_<Dim>& N2);
 
 /**
  * Shannon-Entropy
@@ -169,37 +352,205 @@ double hellinger(
  * source: https://arxiv.org/pdf/1408.4755.pdf, section 3.2
  * 
  */ 
+template<int Dim>
 double entropy(
-    const Normal& N);
+    const Normal_<Dim>& N);
 
 /**
  * Cross Entropy from Q to P
  * or: H(P, Q) = H(P) + D_KL(P || Q)
  * 
  */
+template<int Dim>
 double cross_entropy(
-    const Normal& P,
-    const Normal& Q
+    const Normal_<Dim>& P,
+    const Normal_<Dim>& Q
 );
 
+/**
+ * Metrics for divergenceMatrix
+ */
+enum class Divergence {
+    KULLBACK_LEIBLER,
+    FISHER,
+    WASSERSTEIN,
+    HELLINGER,
+    CROSS_ENTROPY
+};
+
+/**
+ * All-pairs divergences
+ * 
+ * M(i,j) = metric(Ns[i], Ns[j]), e.g. D_KL(Ns[i] || Ns[j])
+ * 
+ * Inverses, log-determinants and covariance square roots are computed 
+ * once per distribution instead of once per pair. Rows are filled in 
+ * parallel (OpenMP). For symmetric metrics (Wasserstein, Hellinger) only 
+ * the upper triangle is evaluated and mirrored.
+ */
+template<int Dim>
+Eigen::MatrixXd divergenceMatrix(
+    const std::vector<Normal_<Dim> >& Ns,
+    Divergence metric);
+
+/**
+ * Rigid transformation of point Gaussians (first order, exact for rigid T)
+ * 
+ * mean' = R * mean + t
+ * cov' = R * cov * R^T
+ */
+Normal3 transform(const Eigen::Affine3d& T, const Normal3& N);
+Normal3 transform(const geometry_msgs::Transform& T, const Normal3& N);
+Normal3 transform(const geometry_msgs::Pose& T, const Normal3& N);
+
+/**
+ * Roll, pitch, yaw (x, y, z) of the pose Gaussians: 
+ * R = Rz(yaw) * Ry(pitch) * Rx(roll) as in tf. matrix_to_rpy returns 
+ * pitch in [-pi/2, pi/2].
+ */
+Eigen::Matrix3d rpy_to_matrix(const Eigen::Vector3d& rpy);
+Eigen::Vector3d matrix_to_rpy(const Eigen::Matrix3d& R);
+
+/**
+ * Rigid transformation of pose Gaussians (first order)
+ * 
+ * Layout as geometry_msgs::PoseWithCovariance: (x, y, z, roll, pitch, yaw)
+ * with R = Rz(yaw) * Ry(pitch) * Rx(roll) as in tf.
+ * 
+ * mean' = T * mean
+ * cov' = J * cov * J^T, J = diag(R, E(rpy')^-1 * R * E(rpy))
+ * 
+ * E maps roll, pitch, yaw rates to angular velocities. It is singular 
+ * at pitch = +-pi/2 (gimbal lock).
+ */
+Normal6 transform(const Eigen::Affine3d& T, const Normal6& N);
+Normal6 transform(const geometry_msgs::Transform& T, const Normal6& N);
+Normal6 transform(const geometry_msgs::Pose& T, const Normal6& N);
+
+/**
+ * Dynamic size: dispatches to the point (dim 3) or pose (dim 6) version
+ * 
+ * throws std::runtime_error for other dimensions
+ */
+Normal transform(const Eigen::Affine3d& T, const Normal& N);
+Normal transform(const geometry_msgs::Transform& T, const Normal& N);
+Normal transform(const geometry_msgs::Pose& T, const Normal& N);
+
+/**
+ * Batch versions: all distributions into the same frame. 
+ * T is converted once. With parallel = true, distributions are 
+ * transformed in parallel (OpenMP).
+ */
+std::vector<Normal3> transform(const geometry_msgs::Transform& T, const std::vector<Normal3>& Ns, bool parallel = false);
+std::vector<Normal3> transform(const geometry_msgs::Pose& T, const std::vector<Normal3>& Ns, bool parallel = false);
+std::vector<Normal6> transform(const geometry_msgs::Transform& T, const std::vector<Normal6>& Ns, bool parallel = false);
+std::vector<Normal6> transform(const geometry_msgs::Pose& T, const std::vector<Normal6>& Ns, bool parallel = false);
+std::vector<Normal> transform(const geometry_msgs::Transform& T, const std::vector<Normal>& Ns, bool parallel = false);
+std::vector<Normal> transform(const geometry_msgs::Pose& T, const std::vector<Normal>& Ns, bool parallel = false);
+
+/**
+ * Unscented Transform of N through a nonlinear function f
+ * 
+ * f: Normal_<Dim>::Vector -> Normal_<DimOut>::Vector
+ * 
+ * 2*dim+1 sigma points are drawn from the Cholesky factor of the 
+ * covariance, mapped by f and recombined. alpha, beta, kappa are the 
+ * usual spread and weighting parameters.
+ * 
+ * source: https://en.wikipedia.org/wiki/Kalman_filter#Unscented_Kalman_filter
+ */
+template<int DimOut, int Dim, typename Function>
+Normal_<DimOut> unscented_transform(
+    const Normal_<Dim>& N, 
+    Function f,
+    double alpha = 1.0,
+    double beta = 2.0,
+    double kappa = 0.0);
+
+/**
+ * Batch Unscented Transform. f has to be thread-safe for parallel = true.
+ * If some elements throw (e.g. a covariance that is not positive definite),
+ * the exception of the lowest index is rethrown after the batch.
+ */
+template<int DimOut, int Dim, typename Function>
+std::vector<Normal_<DimOut> > unscented_transform(
+    const std::vector<Normal_<Dim> >& Ns, 
+    Function f,
+    bool parallel = false,
+    double alpha = 1.0,
+    double beta = 2.0,
+    double kappa = 0.0);
+
+/**
+ * Fixed-size marginals and conditionals of 6x6 covariances as used by 
+ * geometry_msgs::PoseWithCovariance / TwistWithCovariance, e.g. x, y, yaw:
+ * 
+ * Eigen::Matrix3d cov = marginal<3>(pose.covariance, {0, 1, 5});
+ */
+template<int K>
+Eigen::Matrix<double, K, K> marginal(
+    const boost::array<double, 36>& cov,
+    const std::array<size_t, K>& indices);
+
+template<int K>
+Normal_<K> marginal(
+    const geometry_msgs::PoseWithCovariance& pose,
+    const std::array<size_t, K>& indices);
+
+template<int K>
+Normal_<K> marginal(
+    const geometry_msgs::TwistWithCovariance& twist,
+    const std::array<size_t, K>& indices);
+
+template<int K>
+Normal_<6 - K> condition(
+    const geometry_msgs::PoseWithCovariance& pose,
+    const std::array<size_t, K>& indices,
+    const typename Normal_<K>::Vector& values);
+
+template<int K>
+Normal_<6 - K> condition(
+    const geometry_msgs::TwistWithCovariance& twist,
+    const std::array<size_t, K>& indices,
+    const typename Normal_<K>::Vector& values);
+
 // SHORT CUTS
-inline double H(const Normal& P)
+template<int Dim>
+inline double H(const Normal_<Dim>& P)
 {
     return entropy(P);
 } 
 
-inline double H(const Normal& P, const Normal& Q)
+template<int Dim>
+inline double H(const Normal_<Dim>& P, const Normal_<Dim>& Q)
 {
     return cross_entropy(P, Q);
 }
 
-inline double D_KL(const Normal& P, const Normal& Q)
+template<int Dim>
+inline double D_KL(const Normal_<Dim>& P, const Normal_<Dim>& Q)
 {
     return kullback_leibler_divergence(P, Q);
 }
 
 } // namespace stats
 
+// CONVERSIONS
+// Normal6 layout: (x, y, z, roll, pitch, yaw) and (linear, angular)
+void convert(   const geometry_msgs::PoseWithCovariance& from,
+                stats::Normal6& to);
+
+void convert(   const stats::Normal6& from,
+                geometry_msgs::PoseWithCovariance& to);
+
+void convert(   const geometry_msgs::TwistWithCovariance& from,
+                stats::Normal6& to);
+
+void convert(   const stats::Normal6& from,
+                geometry_msgs::TwistWithCovariance& to);
+
 } // namespace rosmath
 
+#include "stats.tcc"
+
 #endif // ROSMATH_EIGEN_STATS_H
\ No newline at end of file
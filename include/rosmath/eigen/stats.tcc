@@ -0,0 +1,883 @@
+namespace rosmath {
+
+namespace stats {
+
+template<int Dim>
+Normal_<Dim>::Normal_()
+:m_mean(Vector::Zero(Dim == Eigen::Dynamic ? 0 : Dim))
+,m_cov(Matrix::Identity(Dim == Eigen::Dynamic ? 0 : Dim, Dim == Eigen::Dynamic ? 0 : Dim))
+,m_log_det(0.0)
+,m_factorized(false)
+,m_inverted(false)
+{
+
+}
+
+template<int Dim>
+Normal_<Dim>::Normal_(const Vector& mean, 
+            const Matrix& cov)
+:m_mean(mean)
+,m_cov(cov)
+,m_log_det(0.0)
+,m_factorized(false)
+,m_inverted(false)
+{
+    
+}
+
+template<int Dim>
+Normal_<Dim>::Normal_(const Normal_& other)
+:m_mean(other.m_mean)
+,m_cov(other.m_cov)
+,m_log_det(other.m_log_det)
+,m_factorized(other.m_factorized)
+,m_inverted(other.m_inverted)
+{
+    // an uncomputed LLT is not initialized
+    if(m_factorized)
+    {
+        m_llt = other.m_llt;
+    }
+    if(m_inverted)
+    {
+        m_cov_inv = other.m_cov_inv;
+    }
+}
+
+template<int Dim>
+Normal_<Dim>& Normal_<Dim>::operator=(const Normal_& other)
+{
+    m_mean = other.m_mean;
+    m_cov = other.m_cov;
+    m_log_det = other.m_log_det;
+    m_factorized = other.m_factorized;
+    m_inverted = other.m_inverted;
+    if(m_factorized)
+    {
+        m_llt = other.m_llt;
+    }
+    if(m_inverted)
+    {
+        m_cov_inv = other.m_cov_inv;
+    }
+    return *this;
+}
+
+template<int Dim>
+Normal_<Dim>::~Normal_()
+{
+    
+}
+
+template<int Dim>
+const Eigen::LLT<typename Normal_<Dim>::Matrix>& Normal_<Dim>::llt() const
+{
+    if(!m_factorized)
+    {
+        m_llt.compute(m_cov);
+        if(m_llt.info() != Eigen::Success)
+        {
+            throw std::runtime_error("Normal: covariance matrix is not positive definite");
+        }
+        // det(cov) = prod(diag(L))^2
+        m_log_det = 2.0 * m_llt.matrixLLT().diagonal().array().log().sum();
+        m_factorized = true;
+    }
+    return m_llt;
+}
+
+template<int Dim>
+double Normal_<Dim>::mahalanobisDist(const Vector& X) const
+{
+    // (x-mu)^T cov^-1 (x-mu) = |L^-1 (x-mu)|^2
+    const Vector d = llt().matrixL().solve(X - m_mean);
+    return d.squaredNorm();
+}
+
+template<int Dim>
+double Normal_<Dim>::logpdf(const Vector& X) const
+{
+    const double dim = static_cast<double>(X.rows());
+    return -0.5 * (mahalanobisDist(X) + covLogDet()) - dim * std::log(SQRT2PI);
+}
+
+template<int Dim>
+double Normal_<Dim>::pdf(const Vector& X) const
+{
+    return std::exp(logpdf(X));
+}
+
+template<int Dim>
+Eigen::VectorXd Normal_<Dim>::mahalanobisDist(const Samples& X, bool parallel) const
+{
+    const auto L = llt().matrixL();
+    Eigen::VectorXd ret(X.cols());
+
+    if(!parallel)
+    {
+        Samples D = X.colwise() - m_mean;
+        L.solveInPlace(D);
+        ret = D.colwise().squaredNorm().transpose();
+        return ret;
+    }
+
+    const Eigen::Index block_size = 1024;
+    const Eigen::Index num_blocks = (X.cols() + block_size - 1) / block_size;
+
+    #pragma omp parallel for
+    for(Eigen::Index b=0; b<num_blocks; b++)
+    {
+        const Eigen::Index start = b * block_size;
+        const Eigen::Index n = std::min(block_size, X.cols() - start);
+        Samples D = X.middleCols(start, n).colwise() - m_mean;
+        L.solveInPlace(D);
+        ret.segment(start, n) = D.colwise().squaredNorm().transpose();
+    }
+
+    return ret;
+}
+
+template<int Dim>
+Eigen::VectorXd Normal_<Dim>::logpdf(const Samples& X, bool parallel) const
+{
+    const double lognorm = -0.5 * covLogDet() - static_cast<double>(dim()) * std::log(SQRT2PI);
+    Eigen::VectorXd ret = mahalanobisDist(X, parallel);
+    ret = (-0.5 * ret.array() + lognorm).matrix();
+    return ret;
+}
+
+template<int Dim>
+Eigen::VectorXd Normal_<Dim>::pdf(const Samples& X, bool parallel) const
+{
+    Eigen::VectorXd ret = logpdf(X, parallel);
+    ret = ret.array().exp().matrix();
+    return ret;
+}
+
+template<int Dim>
+typename Normal_<Dim>::Vector Normal_<Dim>::sample() const
+{
+    std::normal_distribution<double> dist(0.0, 1.0);
+    random::Engine& gen = random::engine();
+    size_t dim = m_mean.rows();
+    Vector x(dim);
+
+    for(size_t i=0; i<dim; i++)
+    {
+        x(i) = dist(gen);
+    }
+
+    return llt().matrixL() * x + m_mean;
+}
+
+template<int Dim>
+typename Normal_<Dim>::Samples Normal_<Dim>::samples(size_t N) const
+{
+    size_t dim = m_mean.rows();
+    Samples samples(dim, N);
+    random::normal_fill(samples.data(), samples.size(), 0.0, 1.0);
+
+    samples = llt().matrixL() * samples;
+    return samples.colwise() + m_mean;
+}
+
+template<int Dim>
+const typename Normal_<Dim>::Vector& Normal_<Dim>::mean() const
+{
+    return m_mean;
+}
+
+template<int Dim>
+const typename Normal_<Dim>::Matrix& Normal_<Dim>::cov() const
+{
+    return m_cov;
+}
+
+template<int Dim>
+void Normal_<Dim>::prepare() const
+{
+    llt();
+    covInv();
+}
+
+template<int Dim>
+const typename Normal_<Dim>::Matrix& Normal_<Dim>::covInv() const
+{
+    if(!m_inverted)
+    {
+        m_cov_inv = llt().solve(Matrix::Identity(dim(), dim()));
+        m_inverted = true;
+    }
+    return m_cov_inv;
+}
+
+template<int Dim>
+double Normal_<Dim>::covDet() const
+{
+    return std::exp(covLogDet());
+}
+
+template<int Dim>
+double Normal_<Dim>::covLogDet() const
+{
+    llt();
+    return m_log_det;
+}
+
+template<int Dim>
+size_t Normal_<Dim>::dim() const
+{
+    return m_cov.rows();
+}
+
+template<int Dim>
+Normal_<Dim> Normal_<Dim>::fit(const Samples& sX)
+{
+    Vector mean = sX.rowwise().mean();
+    Samples centered = sX.colwise() - mean;
+    Matrix cov = (centered * centered.adjoint()) / double(sX.cols() - 1);
+    return Normal_(mean, cov);
+}
+
+template<int Dim>
+Normal_<Dim> Normal_<Dim>::fit(
+        const Samples& sX, 
+        const Eigen::VectorXd& sY)
+{
+    throw std::runtime_error("TODO: implement");
+}
+
+template<int Dim>
+Normal_<Dim> Normal_<Dim>::fuse(const Normal_& N) const
+{
+    Matrix JI = (N.cov() + m_cov).inverse();   
+    Matrix cov = m_cov * JI * N.cov();
+    Vector mean = N.cov() * JI * m_mean + m_cov * JI * N.mean();
+    return Normal_(mean, cov);
+}
+
+template<int Dim>
+template<int DimOut>
+Normal_<DimOut> Normal_<Dim>::transform(const Eigen::Matrix<double, DimOut, Dim>& T) const
+{
+    return Normal_<DimOut>(T * m_mean, T * m_cov * T.transpose());
+}
+
+template<int Dim>
+Normal_<Dim> Normal_<Dim>::add(const Normal_& N) const
+{
+    return Normal_(N.mean() + m_mean, N.cov() + m_cov);
+}
+
+template<int Dim>
+template<int K>
+Normal_<K> Normal_<Dim>::selectMarginal(const Eigen::Matrix<Eigen::Index, K, 1>& indices) const
+{
+    const Eigen::Index n = indices.rows();
+    typename Normal_<K>::Vector mean = Normal_<K>::Vector::Zero(n);
+    typename Normal_<K>::Matrix cov = Normal_<K>::Matrix::Zero(n, n);
+    for(Eigen::Index i=0; i<n; i++)
+    {
+        if(indices(i) < 0 || indices(i) >= m_mean.rows())
+        {
+            throw std::runtime_error("Normal: marginal index " + std::to_string(indices(i)) 
+                + " out of range for dim " + std::to_string(dim()));
+        }
+        mean(i) = m_mean(indices(i));
+    }
+    for(Eigen::Index i=0; i<n; i++)
+    {
+        for(Eigen::Index j=0; j<n; j++)
+        {
+            cov(i, j) = m_cov(indices(i), indices(j));
+        }
+    }
+    return Normal_<K>(mean, cov);
+}
+
+template<int Dim>
+Normal_<Eigen::Dynamic> Normal_<Dim>::marginal(const std::vector<size_t>& indices) const
+{
+    Eigen::Matrix<Eigen::Index, Eigen::Dynamic, 1> idx = Eigen::Matrix<Eigen::Index, Eigen::Dynamic, 1>::Zero(indices.size());
+    for(size_t i=0; i<indices.size(); i++)
+    {
+        idx(i) = indices[i];
+    }
+    return selectMarginal<Eigen::Dynamic>(idx);
+}
+
+template<int Dim>
+template<int K>
+Normal_<K> Normal_<Dim>::marginal(const std::array<size_t, K>& indices) const
+{
+    Eigen::Matrix<Eigen::Index, K, 1> idx;
+    for(int i=0; i<K; i++)
+    {
+        idx(i) = indices[i];
+    }
+    return selectMarginal<K>(idx);
+}
+
+template<int Dim>
+template<int DimA, int DimB>
+Normal_<DimA> Normal_<Dim>::computeCondition(
+    const Eigen::Matrix<Eigen::Index, DimB, 1>& indices, 
+    const Eigen::Matrix<double, DimB, 1>& values) const
+{
+    const Eigen::Index n = m_mean.rows();
+    const Eigen::Index nb = indices.rows();
+    if(values.rows() != nb || nb >= n)
+    {
+        throw std::runtime_error("Normal: condition needs one value per index and at least one free dimension");
+    }
+
+    // complement: free dimensions a
+    Eigen::Matrix<bool, Dim, 1> given = Eigen::Matrix<bool, Dim, 1>::Constant(n, false);
+    for(Eigen::Index i=0; i<nb; i++)
+    {
+        if(indices(i) < 0 || indices(i) >= n || given(indices(i)))
+        {
+            throw std::runtime_error("Normal: invalid or duplicate condition index " + std::to_string(indices(i)));
+        }
+        given(indices(i)) = true;
+    }
+
+    Eigen::Matrix<Eigen::Index, DimA, 1> free = Eigen::Matrix<Eigen::Index, DimA, 1>::Zero(n - nb);
+    for(Eigen::Index i=0, j=0; i<n; i++)
+    {
+        if(!given(i))
+        {
+            free(j++) = i;
+        }
+    }
+
+    const Eigen::Index na = free.rows();
+    const Matrix& P = covInv();
+
+    using MatrixA = typename Normal_<DimA>::Matrix;
+    using VectorA = typename Normal_<DimA>::Vector;
+    MatrixA P_aa = MatrixA::Zero(na, na);
+    VectorA mean_a = VectorA::Zero(na);
+    VectorA P_ab_d = VectorA::Zero(na);
+
+    const Eigen::Matrix<double, DimB, 1> d = [&]() {
+        Eigen::Matrix<double, DimB, 1> ret = Eigen::Matrix<double, DimB, 1>::Zero(nb);
+        for(Eigen::Index j=0; j<nb; j++)
+        {
+            ret(j) = values(j) - m_mean(indices(j));
+        }
+        return ret;
+    }();
+
+    for(Eigen::Index i=0; i<na; i++)
+    {
+        mean_a(i) = m_mean(free(i));
+        for(Eigen::Index j=0; j<na; j++)
+        {
+            P_aa(i, j) = P(free(i), free(j));
+        }
+        double acc = 0.0;
+        for(Eigen::Index j=0; j<nb; j++)
+        {
+            acc += P(free(i), indices(j)) * d(j);
+        }
+        P_ab_d(i) = acc;
+    }
+
+    const Eigen::LLT<MatrixA> llt(P_aa);
+    const MatrixA cov_a = llt.solve(MatrixA::Identity(na, na));
+    return Normal_<DimA>(mean_a - cov_a * P_ab_d, cov_a);
+}
+
+template<int Dim>
+Normal_<Eigen::Dynamic> Normal_<Dim>::condition(
+    const std::vector<size_t>& indices, 
+    const Eigen::VectorXd& values) const
+{
+    Eigen::Matrix<Eigen::Index, Eigen::Dynamic, 1> idx = Eigen::Matrix<Eigen::Index, Eigen::Dynamic, 1>::Zero(indices.size());
+    for(size_t i=0; i<indices.size(); i++)
+    {
+        idx(i) = indices[i];
+    }
+    return computeCondition<Eigen::Dynamic, Eigen::Dynamic>(idx, values);
+}
+
+template<int Dim>
+template<int K>
+Normal_<(Dim == Eigen::Dynamic ? Eigen::Dynamic : Dim - K)> Normal_<Dim>::condition(
+    const std::array<size_t, K>& indices, 
+    const typename Normal_<K>::Vector& values) const
+{
+    Eigen::Matrix<Eigen::Index, K, 1> idx;
+    for(int i=0; i<K; i++)
+    {
+        idx(i) = indices[i];
+    }
+    return computeCondition<(Dim == Eigen::Dynamic ? Eigen::Dynamic : Dim - K), K>(idx, values);
+}
+
+template<int Dim>
+InformationFusion_<Dim>::InformationFusion_()
+:m_size(0)
+{
+    if(Dim != Eigen::Dynamic)
+    {
+        clear();
+    }
+}
+
+template<int Dim>
+void InformationFusion_<Dim>::update(const Normal_<Dim>& N, double sign)
+{
+    if(m_information.rows() == 0)
+    {
+        // dynamic size: take dimension from first measurement
+        m_information = Matrix::Zero(N.dim(), N.dim());
+        m_information_vector = Vector::Zero(N.dim());
+    }
+
+    if(m_information.rows() != N.dim())
+    {
+        throw std::runtime_error("InformationFusion: dimension mismatch");
+    }
+
+    const Matrix& P = N.covInv();
+    m_information += sign * P;
+    m_information_vector += sign * (P * N.mean());
+}
+
+template<int Dim>
+void InformationFusion_<Dim>::add(const Normal_<Dim>& N)
+{
+    update(N, 1.0);
+    m_size++;
+}
+
+template<int Dim>
+void InformationFusion_<Dim>::remove(const Normal_<Dim>& N)
+{
+    if(m_size == 0)
+    {
+        throw std::runtime_error("InformationFusion: nothing to remove");
+    }
+    update(N, -1.0);
+    m_size--;
+}
+
+template<int Dim>
+size_t InformationFusion_<Dim>::size() const
+{
+    return m_size;
+}
+
+template<int Dim>
+void InformationFusion_<Dim>::clear()
+{
+    m_information.setZero();
+    m_information_vector.setZero();
+    m_size = 0;
+}
+
+template<int Dim>
+const typename InformationFusion_<Dim>::Matrix& InformationFusion_<Dim>::information() const
+{
+    return m_information;
+}
+
+template<int Dim>
+const typename InformationFusion_<Dim>::Vector& InformationFusion_<Dim>::informationVector() const
+{
+    return m_information_vector;
+}
+
+template<int Dim>
+Normal_<Dim> InformationFusion_<Dim>::normal() const
+{
+    if(m_size == 0)
+    {
+        throw std::runtime_error("InformationFusion: no measurements");
+    }
+
+    Eigen::LLT<Matrix> llt(m_information);
+    if(llt.info() != Eigen::Success)
+    {
+        throw std::runtime_error("InformationFusion: information matrix is not positive definite");
+    }
+
+    const Matrix cov = llt.solve(Matrix::Identity(m_information.rows(), m_information.cols()));
+    const Vector mean = cov * m_information_vector;
+    return Normal_<Dim>(mean, cov);
+}
+
+template<int Dim>
+Normal_<Dim> fuse(const std::vector<Normal_<Dim> >& Ns)
+{
+    InformationFusion_<Dim> fusion;
+    for(const Normal_<Dim>& N : Ns)
+    {
+        fusion.add(N);
+    }
+    return fusion.normal();
+}
+
+template<int Dim>
+double kullback_leibler_divergence(const Normal_<Dim>& N0, const Normal_<Dim>& N1)
+{
+    double dim = N1.mean().rows();
+    return 0.5 * ( ( N1.covInv() * N0.cov() ).trace() + N1.mahalanobisDist(N0.mean()) - dim + N1.covLogDet() - N0.covLogDet() );
+}
+
+template<int Dim>
+double fisher_information(const Normal_<Dim>& N1, const Normal_<Dim>& N2)
+{
+    return (N2.covInv() * (N1.mean() - N2.mean())).squaredNorm() + (N2.covInv() * N2.covInv() * N1.cov() - 2.0 * N2.covInv() + N1.covInv() ).trace();
+}
+
+template<int Dim>
+double wasserstein(
+    const Normal_<Dim>& N1,
+    const Normal_<Dim>& N2)
+{
+    using Matrix = typename Normal_<Dim>::Matrix;
+    Matrix cov2sqrt = N2.cov().sqrt();
+    Matrix cross = cov2sqrt * N1.cov() * cov2sqrt;
+    Matrix cross_sqrt = cross.sqrt();
+    return std::sqrt((N2.mean() - N1.mean()).squaredNorm() + 
+            (
+                N2.cov() + N1.cov() 
+                - 2 * cross_sqrt
+            ).trace());
+}
+
+template<int Dim>
+double hellinger(
+    const Normal_<Dim>& N1,
+    const Normal_<Dim>& N2)
+{
+    using Matrix = typename Normal_<Dim>::Matrix;
+    const Matrix cov_sum = N2.cov() + N1.cov();
+    const typename Normal_<Dim>::Vector d = N2.mean() - N1.mean();
+    double combDet1 = (N2.cov() * N1.cov()).determinant();
+    double combDet2 = (cov_sum / 2.0).determinant();
+    return std::sqrt(2.0 - 2.0 * std::sqrt(std::sqrt(combDet1)) / std::sqrt(combDet2) 
+       * std::exp(-1.0/4.0 * d.dot(cov_sum.inverse() * d) ) );
+}
+
+template<int Dim>
+double entropy(
+    const Normal_<Dim>& N)
+{
+    double dim = static_cast<double>(N.dim());
+    return 0.5 * N.covLogDet() + 0.5 * dim * (1 + std::log(2 * M_PI) );
+}
+
+template<int Dim>
+double cross_entropy(
+    const Normal_<Dim>& P, 
+    const Normal_<Dim>& Q)
+{
+    return entropy(P) + kullback_leibler_divergence(P, Q);
+}
+
+template<int Dim>
+Eigen::MatrixXd divergenceMatrix(
+    const std::vector<Normal_<Dim> >& Ns,
+    Divergence metric)
+{
+    using Matrix = typename Normal_<Dim>::Matrix;
+    using Vector = typename Normal_<Dim>::Vector;
+    using Solver = Eigen::SelfAdjointEigenSolver<Matrix>;
+
+    const int N = static_cast<int>(Ns.size());
+    Eigen::MatrixXd M = Eigen::MatrixXd::Zero(N, N);
+    if(N == 0)
+    {
+        return M;
+    }
+
+    const double dim = static_cast<double>(Ns[0].dim());
+    const bool symmetric = (metric == Divergence::WASSERSTEIN 
+                         || metric == Divergence::HELLINGER);
+
+    // per distribution caches
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix> > cov_inv;
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix> > cov_inv_sq;
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix> > cov_sqrt;
+    std::vector<double> log_det(N), trace_cov(N), trace_inv(N);
+
+    if(metric == Divergence::KULLBACK_LEIBLER 
+        || metric == Divergence::CROSS_ENTROPY
+        || metric == Divergence::FISHER)
+    {
+        cov_inv.resize(N);
+    }
+    if(metric == Divergence::FISHER)
+    {
+        cov_inv_sq.resize(N);
+    }
+    if(metric == Divergence::WASSERSTEIN)
+    {
+        cov_sqrt.resize(N);
+    }
+
+    // factorize serially: exceptions must not escape the parallel regions
+    for(int i=0; i<N; i++)
+    {
+        Ns[i].llt();
+    }
+
+    #pragma omp parallel for
+    for(int i=0; i<N; i++)
+    {
+        log_det[i] = Ns[i].covLogDet();
+        trace_cov[i] = Ns[i].cov().trace();
+        if(!cov_inv.empty())
+        {
+            cov_inv[i] = Ns[i].covInv();
+            trace_inv[i] = cov_inv[i].trace();
+        }
+        if(!cov_inv_sq.empty())
+        {
+            cov_inv_sq[i] = cov_inv[i] * cov_inv[i];
+        }
+        if(!cov_sqrt.empty())
+        {
+            cov_sqrt[i] = Solver(Ns[i].cov()).operatorSqrt();
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int i=0; i<N; i++)
+    {
+        const Normal_<Dim>& Ni = Ns[i];
+        for(int j = (symmetric ? i + 1 : 0); j<N; j++)
+        {
+            if(i == j)
+            {
+                // D(N || N) = 0, except for the entropy part
+                if(metric == Divergence::CROSS_ENTROPY)
+                {
+                    M(i,j) = 0.5 * log_det[i] + 0.5 * dim * (1 + std::log(2 * M_PI));
+                }
+                continue;
+            }
+
+            const Normal_<Dim>& Nj = Ns[j];
+            const Vector d = Nj.mean() - Ni.mean();
+
+            switch(metric)
+            {
+                case Divergence::KULLBACK_LEIBLER:
+                case Divergence::CROSS_ENTROPY: {
+                    // tr(A*B) = sum(A .* B) for symmetric A, B
+                    double val = 0.5 * ( cov_inv[j].cwiseProduct(Ni.cov()).sum() 
+                        + d.dot(cov_inv[j] * d) - dim + log_det[j] - log_det[i] );
+                    if(metric == Divergence::CROSS_ENTROPY)
+                    {
+                        val += 0.5 * log_det[i] + 0.5 * dim * (1 + std::log(2 * M_PI));
+                    }
+                    M(i,j) = val;
+                    break;
+                }
+                case Divergence::FISHER: {
+                    M(i,j) = (cov_inv[j] * d).squaredNorm() 
+                        + cov_inv_sq[j].cwiseProduct(Ni.cov()).sum() 
+                        - 2.0 * trace_inv[j] + trace_inv[i];
+                    break;
+                }
+                case Divergence::WASSERSTEIN: {
+                    // tr(sqrt(A)) = sum(sqrt(eigenvalues(A)))
+                    const Matrix cross = cov_sqrt[j] * Ni.cov() * cov_sqrt[j];
+                    const double trace_cross_sqrt = Solver(cross, Eigen::EigenvaluesOnly)
+                        .eigenvalues().cwiseMax(0.0).cwiseSqrt().sum();
+                    M(i,j) = std::sqrt(std::max(0.0, 
+                        d.squaredNorm() + trace_cov[i] + trace_cov[j] - 2.0 * trace_cross_sqrt));
+                    break;
+                }
+                case Divergence::HELLINGER: {
+                    const Eigen::LLT<Matrix> llt_sum(Ni.cov() + Nj.cov());
+                    const Matrix L = llt_sum.matrixL();
+                    // log(det((Ci + Cj)/2))
+                    const double log_det_mid = 2.0 * L.diagonal().array().log().sum() - dim * std::log(2.0);
+                    const double bc = std::exp(0.25 * (log_det[i] + log_det[j]) - 0.5 * log_det_mid 
+                        - 0.25 * d.dot(llt_sum.solve(d)));
+                    M(i,j) = std::sqrt(std::max(0.0, 2.0 - 2.0 * bc));
+                    break;
+                }
+            }
+
+            if(symmetric)
+            {
+                M(j,i) = M(i,j);
+            }
+        }
+    }
+
+    return M;
+}
+
+template<int DimOut, int Dim, typename Function>
+Normal_<DimOut> unscented_transform(
+    const Normal_<Dim>& N, 
+    Function f,
+    double alpha,
+    double beta,
+    double kappa)
+{
+    using VectorOut = typename Normal_<DimOut>::Vector;
+    using MatrixOut = typename Normal_<DimOut>::Matrix;
+    using Matrix = typename Normal_<Dim>::Matrix;
+
+    const double n = static_cast<double>(N.dim());
+    const double lambda = alpha * alpha * (n + kappa) - n;
+
+    const double wm0 = lambda / (n + lambda);
+    const double wc0 = wm0 + (1.0 - alpha * alpha + beta);
+    const double wi = 1.0 / (2.0 * (n + lambda));
+
+    const Matrix L = N.llt().matrixL();
+    const Matrix S = std::sqrt(n + lambda) * L;
+
+    const VectorOut y0 = f(N.mean());
+    std::vector<VectorOut, Eigen::aligned_allocator<VectorOut> > ys;
+    ys.reserve(2 * N.dim());
+    for(size_t i=0; i<N.dim(); i++)
+    {
+        ys.push_back(f(N.mean() + S.col(i)));
+        ys.push_back(f(N.mean() - S.col(i)));
+    }
+
+    VectorOut mean = wm0 * y0;
+    for(const VectorOut& y : ys)
+    {
+        mean += wi * y;
+    }
+
+    VectorOut d = y0 - mean;
+    MatrixOut cov = wc0 * d * d.transpose();
+    for(const VectorOut& y : ys)
+    {
+        d = y - mean;
+        cov += wi * d * d.transpose();
+    }
+
+    return Normal_<DimOut>(mean, cov);
+}
+
+template<int DimOut, int Dim, typename Function>
+std::vector<Normal_<DimOut> > unscented_transform(
+    const std::vector<Normal_<Dim> >& Ns, 
+    Function f,
+    bool parallel,
+    double alpha,
+    double beta,
+    double kappa)
+{
+    std::vector<Normal_<DimOut> > ret;
+    if(Ns.empty())
+    {
+        return ret;
+    }
+
+    ret.resize(Ns.size(), unscented_transform<DimOut>(Ns[0], f, alpha, beta, kappa));
+
+    // exceptions of the factorization or of f must not escape the parallel 
+    // region: the one of the lowest index is rethrown afterwards
+    std::exception_ptr error;
+    size_t error_index = Ns.size();
+
+    #pragma omp parallel for if(parallel)
+    for(size_t i=1; i<Ns.size(); i++)
+    {
+        try {
+            ret[i] = unscented_transform<DimOut>(Ns[i], f, alpha, beta, kappa);
+        } catch(...) {
+            #pragma omp critical(rosmath_unscented_transform)
+            {
+                if(i < error_index)
+                {
+                    error = std::current_exception();
+                    error_index = i;
+                }
+            }
+        }
+    }
+
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    return ret;
+}
+
+template<int K>
+Eigen::Matrix<double, K, K> marginal(
+    const boost::array<double, 36>& cov,
+    const std::array<size_t, K>& indices)
+{
+    for(int i=0; i<K; i++)
+    {
+        if(indices[i] >= 6)
+        {
+            throw std::runtime_error("marginal: index " + std::to_string(indices[i]) 
+                + " out of range for a 6x6 covariance");
+        }
+    }
+
+    Eigen::Matrix<double, K, K> ret;
+    for(int i=0; i<K; i++)
+    {
+        for(int j=0; j<K; j++)
+        {
+            ret(i, j) = cov[indices[i] * 6 + indices[j]];
+        }
+    }
+    return ret;
+}
+
+template<int K>
+Normal_<K> marginal(
+    const geometry_msgs::PoseWithCovariance& pose,
+    const std::array<size_t, K>& indices)
+{
+    Normal6 N;
+    convert(pose, N);
+    return N.marginal<K>(indices);
+}
+
+template<int K>
+Normal_<K> marginal(
+    const geometry_msgs::TwistWithCovariance& twist,
+    const std::array<size_t, K>& indices)
+{
+    Normal6 N;
+    convert(twist, N);
+    return N.marginal<K>(indices);
+}
+
+template<int K>
+Normal_<6 - K> condition(
+    const geometry_msgs::PoseWithCovariance& pose,
+    const std::array<size_t, K>& indices,
+    const typename Normal_<K>::Vector& values)
+{
+    Normal6 N;
+    convert(pose, N);
+    return N.condition<K>(indices, values);
+}
+
+template<int K>
+Normal_<6 - K> condition(
+    const geometry_msgs::TwistWithCovariance& twist,
+    const std::array<size_t, K>& indices,
+    const typename Normal_<K>::Vector& values)
+{
+    Normal6 N;
+    convert(twist, N);
+    return N.condition<K>(indices, values);
+}
+
+} // namespace stats
+
+} // namespace rosmath
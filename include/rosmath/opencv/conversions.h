@@ -5,7 +5,9 @@
 #include "rosmath/conversions.h"
 #include "rosmath/eigen/conversions.h"
 
+#include <sensor_msgs/PointCloud.h>
 #include <opencv2/core.hpp>
+#include <vector>
 
 namespace rosmath 
 {
@@ -22,6 +24,44 @@ void convert(const geometry_msgs::Vector3& from, cv::Mat& to);
 void convert(const cv::Mat& from, geometry_msgs::Point& to);
 void convert(const cv::Mat& from, geometry_msgs::Vector3& to);
 
+// POINT SETS
+// matrices are N x 3 with one point per row. N x 1 or 1 x N matrices with
+// three channels are accepted as input as well. The output has the given
+// depth (CV_32F or CV_64F)
+void convert(const std::vector<geometry_msgs::Point>& from, cv::Mat& to, 
+    const int depth = CV_64F);
+void convert(const std::vector<geometry_msgs::Point32>& from, cv::Mat& to, 
+    const int depth = CV_32F);
+// points only
+void convert(const sensor_msgs::PointCloud& from, cv::Mat& to, 
+    const int depth = CV_32F);
+
+void convert(const cv::Mat& from, std::vector<geometry_msgs::Point>& to);
+void convert(const cv::Mat& from, std::vector<geometry_msgs::Point32>& to);
+// replaces the points. channels are kept if the number of points is unchanged
+void convert(const cv::Mat& from, sensor_msgs::PointCloud& to);
+
+void convert(const std::vector<geometry_msgs::Point>& from, std::vector<cv::Point3f>& to);
+void convert(const std::vector<geometry_msgs::Point32>& from, std::vector<cv::Point3f>& to);
+void convert(const sensor_msgs::PointCloud& from, std::vector<cv::Point3f>& to);
+
+void convert(const std::vector<cv::Point3f>& from, std::vector<geometry_msgs::Point>& to);
+void convert(const std::vector<cv::Point3f>& from, std::vector<geometry_msgs::Point32>& to);
+void convert(const std::vector<cv::Point3f>& from, sensor_msgs::PointCloud& to);
+
+/**
+ * @brief N x 3 matrix header on the memory of the points, no copy
+ * 
+ * The matrix is CV_64F for Point and CV_32F for Point32. It is valid as long 
+ * as the vector is not reallocated. The const versions must not be written.
+ */
+cv::Mat wrap(std::vector<geometry_msgs::Point>& points);
+cv::Mat wrap(const std::vector<geometry_msgs::Point>& points);
+cv::Mat wrap(std::vector<geometry_msgs::Point32>& points);
+cv::Mat wrap(const std::vector<geometry_msgs::Point32>& points);
+cv::Mat wrap(sensor_msgs::PointCloud& cloud);
+cv::Mat wrap(const sensor_msgs::PointCloud& cloud);
+
 /**
  * @brief Calculates the corresponding rvec, tvec from an optical ROS pose (x-right, y-down, z-front).
  * The rvec, tvec can be used to project points etc. Therefore, the rvec, tvec are the inverse of the ROS pose.
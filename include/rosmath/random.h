@@ -2,99 +2,493 @@
 #define ROSMATH_RANDOM_H
 
 #include "math.h"
+#include "random/philox.h"
+#include "random/lowdiscrepancy.h"
 #include <random>
 namespace rosmath {
 
 namespace random {
 
-static std::default_random_engine engine;
+using Engine = std::mt19937_64;
 
-static void seed(size_t seed)
-{
-    engine = std::default_random_engine(seed);
-}
+/**
+ * Engine of the calling thread
+ * 
+ * Every thread owns its engine (thread_local). Engines are seeded lazily 
+ * from the global seed and a per-thread index, which is handed out in 
+ * order of first use after each call to seed(). Functions without an 
+ * explicit engine argument use this engine, so they are safe to call 
+ * concurrently. Pass an engine explicitly to avoid the thread_local 
+ * lookup in hot loops or to control the stream.
+ */
+Engine& engine();
+
+/**
+ * Set the global seed. All thread engines are reseeded on their next use.
+ */
+void seed(size_t seed);
+
+/**
+ * Philox keyed by the engine of the calling thread. The bulk functions 
+ * without an explicit generator draw their keys from here.
+ */
+Philox thread_philox();
 
 size_t uniform_number(
     const size_t min,
     const size_t max);
+size_t uniform_number(
+    Engine& gen,
+    const size_t min,
+    const size_t max);
 
 std::vector<size_t> uniform_numbers(
     const size_t min,
     const size_t max,
     const size_t size);
+std::vector<size_t> uniform_numbers(
+    Engine& gen,
+    const size_t min,
+    const size_t max,
+    const size_t size);
 
 double uniform_number(
     const double min,
     const double max);
+double uniform_number(
+    Engine& gen,
+    const double min,
+    const double max);
 
 std::vector<double> uniform_numbers(
     const double min,
     const double max,
     const size_t size);
+std::vector<double> uniform_numbers(
+    Engine& gen,
+    const double min,
+    const double max,
+    const size_t size);
 
 double uniform_angle();
+double uniform_angle(Engine& gen);
 
 geometry_msgs::Point uniform_point(
     const geometry_msgs::Point pmin, 
     const geometry_msgs::Point pmax);
+geometry_msgs::Point uniform_point(
+    Engine& gen,
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax);
 
 std::vector<geometry_msgs::Point> uniform_points(
     const geometry_msgs::Point pmin, 
     const geometry_msgs::Point pmax,
     const size_t size
 );
+std::vector<geometry_msgs::Point> uniform_points(
+    Engine& gen,
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax,
+    const size_t size);
 
 geometry_msgs::Quaternion uniform_quaternion();
+geometry_msgs::Quaternion uniform_quaternion(Engine& gen);
+
+geometry_msgs::Quaternion uniform_quaternion(
+    const geometry_msgs::Vector3 axis);
 geometry_msgs::Quaternion uniform_quaternion(
+    Engine& gen,
     const geometry_msgs::Vector3 axis);
 
 void uniform_fill(
     std::vector<size_t>& data, 
     const size_t min,
     const size_t max);
+void uniform_fill(
+    Engine& gen,
+    std::vector<size_t>& data, 
+    const size_t min,
+    const size_t max);
 
 void uniform_fill(
     std::vector<double>& data, 
     const double min,
     const double max);
+void uniform_fill(
+    Engine& gen,
+    std::vector<double>& data, 
+    const double min,
+    const double max);
 
 void uniform_fill(
     std::vector<geometry_msgs::Point>& data, 
     const geometry_msgs::Point pmin, 
     const geometry_msgs::Point pmax);
+void uniform_fill(
+    Engine& gen,
+    std::vector<geometry_msgs::Point>& data, 
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax);
 
 double normal_number(
     const double mu,
     const double sigma);
+double normal_number(
+    Engine& gen,
+    const double mu,
+    const double sigma);
 
 geometry_msgs::Point normal_point(
     const geometry_msgs::Point mu,
     const geometry_msgs::Point sigma);
+geometry_msgs::Point normal_point(
+    Engine& gen,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma);
 
 geometry_msgs::Quaternion normal_quaternion(
     const double sx, const double sy, const double sz);
+geometry_msgs::Quaternion normal_quaternion(
+    Engine& gen,
+    const double sx, const double sy, const double sz);
 
 std::vector<double> normal_numbers(
     const double mu, 
     const double sigma,
     const size_t size);
+std::vector<double> normal_numbers(
+    Engine& gen,
+    const double mu, 
+    const double sigma,
+    const size_t size);
 
 std::vector<geometry_msgs::Point> normal_points(
     const geometry_msgs::Point mu,
     const geometry_msgs::Point sigma,
     const size_t size);
+std::vector<geometry_msgs::Point> normal_points(
+    Engine& gen,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma,
+    const size_t size);
 
 void normal_fill(
     std::vector<double>& data,
     const double mu,
     const double sigma);
+void normal_fill(
+    Engine& gen,
+    std::vector<double>& data,
+    const double mu,
+    const double sigma);
 
 void normal_fill(
     std::vector<geometry_msgs::Point>& data,
     const geometry_msgs::Point mu,
     const geometry_msgs::Point sigma);
+void normal_fill(
+    Engine& gen,
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma);
+
+/**
+ * Counter-based versions (Philox)
+ * 
+ * Element k of the output is element (offset + k) of the stream defined 
+ * by gen (seed, stream). Point coordinates count as three elements. 
+ * The result does not depend on how a large sample is split into chunks 
+ * or on the number of threads. Large fills run in parallel (OpenMP).
+ * 
+ * Element i is computed from block i / 2, so the same offset on the 
+ * uniform and normal streams of one generator is correlated: use 
+ * different stream ids for independent quantities.
+ */
+void uniform_fill(
+    const Philox& gen,
+    std::vector<size_t>& data, 
+    const size_t min,
+    const size_t max,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<double>& data, 
+    const double min,
+    const double max,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Point>& data, 
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax,
+    const size_t offset = 0);
 
+void normal_fill(
+    const Philox& gen,
+    std::vector<double>& data,
+    const double mu,
+    const double sigma,
+    const size_t offset = 0);
 
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma,
+    const size_t offset = 0);
+
+std::vector<double> uniform_numbers(
+    const Philox& gen,
+    const double min,
+    const double max,
+    const size_t size,
+    const size_t offset = 0);
+
+std::vector<geometry_msgs::Point> uniform_points(
+    const Philox& gen,
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax,
+    const size_t size,
+    const size_t offset = 0);
+
+std::vector<double> normal_numbers(
+    const Philox& gen,
+    const double mu, 
+    const double sigma,
+    const size_t size,
+    const size_t offset = 0);
+
+std::vector<geometry_msgs::Point> normal_points(
+    const Philox& gen,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma,
+    const size_t size,
+    const size_t offset = 0);
+
+/**
+ * Bulk generators into raw buffers and Eigen matrices (column-major 
+ * order of data()).
+ * 
+ * Philox blocks are generated in tiles and transformed with 
+ * Box-Muller in vectorizable loops (omp simd), tiles in parallel. 
+ * Versions without a generator key a Philox with the engine of the 
+ * calling thread, so they follow seed().
+ */
+void uniform_fill(
+    const Philox& gen,
+    double* data,
+    const size_t size,
+    const double min,
+    const double max,
+    const size_t offset = 0);
+
+void normal_fill(
+    const Philox& gen,
+    double* data,
+    const size_t size,
+    const double mu,
+    const double sigma,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max,
+    const size_t offset = 0);
+
+void normal_fill(
+    const Philox& gen,
+    Eigen::MatrixXd& data,
+    const double mu,
+    const double sigma,
+    const size_t offset = 0);
+
+void uniform_fill(
+    double* data,
+    const size_t size,
+    const double min,
+    const double max);
+
+void normal_fill(
+    double* data,
+    const size_t size,
+    const double mu,
+    const double sigma);
+
+void uniform_fill(
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max);
+
+void normal_fill(
+    Eigen::MatrixXd& data,
+    const double mu,
+    const double sigma);
+
+/**
+ * Batch orientations and poses
+ * 
+ * Fill all elements of the container. Uniform orientations are uniform on 
+ * SO(3) or uniform rotations about a fixed axis. Gaussian orientations 
+ * are normalize(sx * n_x, sy * n_y, sz * n_z, 1) (see normal_quaternion), 
+ * applied in the frame of the mean (q = q_mean * dq). Position noise 
+ * is added in the parent frame.
+ * 
+ * Rotations are computed in vectorizable loops from bulk Philox 
+ * samples. Philox versions consume consecutive elements after offset: 
+ * 3 per position, 3 per orientation and 1 per rotation about an axis.
+ */
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset = 0);
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const double sx, const double sy, const double sz,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset = 0);
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset = 0);
+
+void normal_fill(
+    const Philox& gen,
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset = 0);
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Transform mean,
+    const geometry_msgs::Vector3 sigma,
+    const double sx, const double sy, const double sz,
+    const size_t offset = 0);
+
+void uniform_fill(
+    std::vector<geometry_msgs::Quaternion>& data);
+
+void uniform_fill(
+    std::vector<geometry_msgs::Quaternion>& data,
+    const geometry_msgs::Vector3 axis);
+
+void normal_fill(
+    std::vector<geometry_msgs::Quaternion>& data,
+    const double sx, const double sy, const double sz);
+
+void uniform_fill(
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax);
+
+void uniform_fill(
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis);
+
+void normal_fill(
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz);
+
+void uniform_fill(
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax);
+
+void uniform_fill(
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis);
+
+void normal_fill(
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz);
+
+void uniform_fill(
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax);
+
+void uniform_fill(
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax,
+    const geometry_msgs::Vector3 axis);
+
+void normal_fill(
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Transform mean,
+    const geometry_msgs::Vector3 sigma,
+    const double sx, const double sy, const double sz);
 
 } // namespace random
 
@@ -0,0 +1,152 @@
+#ifndef ROSMATH_RANDOM_LOWDISCREPANCY_H
+#define ROSMATH_RANDOM_LOWDISCREPANCY_H
+
+#include <geometry_msgs/Point.h>
+#include <geometry_msgs/Quaternion.h>
+#include <Eigen/Dense>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace rosmath {
+
+namespace random {
+
+/**
+ * @brief Sobol sequence in up to 21 dimensions
+ *
+ * Direction numbers of Joe and Kuo (new-joe-kuo-6.21201), points in
+ * Gray code order with 32 bit resolution (period 2^32). Point i is a 
+ * pure function of i, so chunks [offset, offset + n) can be generated 
+ * independently (skip-ahead).
+ *
+ * Scrambling applies a random digital shift (XOR per dimension) drawn
+ * from seed. Shifted sequences keep the net properties and give
+ * unbiased estimates for randomized QMC.
+ *
+ * source: Joe, Kuo - "Constructing Sobol sequences with better
+ * two-dimensional projections", SIAM J. Sci. Comput. 30, 2008
+ */
+class Sobol {
+public:
+    static constexpr size_t MAX_DIMENSIONS = 21;
+
+    Sobol(const size_t dimensions,
+        const bool scramble = false,
+        const uint64_t seed = 0);
+
+    size_t dimensions() const;
+
+    // coordinate dim of point index, in [0, 1)
+    double value(const uint64_t index, const size_t dim) const;
+
+    /**
+     * Points [offset, offset + size) into out (size x dimensions values,
+     * point-major: coordinate d of point k at out[k * dimensions + d]).
+     * Large fills run in parallel (OpenMP).
+     */
+    void fill(const uint64_t offset, const size_t size, double* out) const;
+
+private:
+    size_t m_dims;
+    // 32 direction numbers per dimension
+    std::vector<std::array<uint32_t, 32> > m_v;
+    std::vector<uint32_t> m_shift;
+};
+
+/**
+ * @brief Halton sequence in up to 21 dimensions
+ *
+ * Radical inverses in the first prime bases. Point i is a pure function
+ * of i (skip-ahead). Scrambling permutes the digits of each base
+ * with a random permutation drawn from seed (fixing 0), which removes the
+ * correlation between higher dimensions of the plain sequence.
+ */
+class Halton {
+public:
+    static constexpr size_t MAX_DIMENSIONS = 21;
+
+    Halton(const size_t dimensions,
+        const bool scramble = false,
+        const uint64_t seed = 0);
+
+    size_t dimensions() const;
+
+    // coordinate dim of point index, in [0, 1)
+    double value(const uint64_t index, const size_t dim) const;
+
+    // see Sobol::fill
+    void fill(const uint64_t offset, const size_t size, double* out) const;
+
+private:
+    size_t m_dims;
+    // digit permutation per dimension (identity if not scrambled)
+    std::vector<std::vector<uint32_t> > m_perm;
+};
+
+/**
+ * Quasi-random versions of the uniform generators
+ *
+ * Element k is point (offset + k) of the sequence. Points use the first
+ * three dimensions, orientations the first three dimensions mapped to
+ * SO(3) (Shoemake). Matrices get one point per column and need
+ * rows <= dimensions. Throws std::runtime_error if the sequence has too
+ * few dimensions.
+ */
+void uniform_fill(
+    const Sobol& seq,
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Sobol& seq,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Sobol& seq,
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max,
+    const size_t offset = 0);
+
+std::vector<geometry_msgs::Point> uniform_points(
+    const Sobol& seq,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t size,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Halton& seq,
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Halton& seq,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const size_t offset = 0);
+
+void uniform_fill(
+    const Halton& seq,
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max,
+    const size_t offset = 0);
+
+std::vector<geometry_msgs::Point> uniform_points(
+    const Halton& seq,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t size,
+    const size_t offset = 0);
+
+} // namespace random
+
+} // namespace rosmath
+
+#endif // ROSMATH_RANDOM_LOWDISCREPANCY_H
@@ -0,0 +1,206 @@
+#ifndef ROSMATH_RANDOM_PHILOX_H
+#define ROSMATH_RANDOM_PHILOX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace rosmath {
+
+namespace random {
+
+/**
+ * @brief Philox4x32-10 counter-based random number generator
+ * 
+ * Each 128 bit output block is a pure function of (key, counter):
+ * key = seed, counter = (block index, stream). Any block can be computed 
+ * independently, so chunks of a large sample can be generated on any 
+ * thread with identical results.
+ * 
+ * The sequential operator() makes Philox usable with the std 
+ * distributions (UniformRandomBitGenerator).
+ * 
+ * source: Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11
+ */
+class Philox {
+public:
+    using result_type = uint32_t;
+    using Block = std::array<uint32_t, 4>;
+
+    explicit Philox(uint64_t seed = 0, uint64_t stream = 0)
+    :m_key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}
+    ,m_stream(stream)
+    ,m_counter(0)
+    ,m_index(4)
+    {
+
+    }
+
+    uint64_t stream() const
+    {
+        return m_stream;
+    }
+
+    // output block for a block index
+    inline Block block(uint64_t counter) const
+    {
+        Block ctr = {
+            static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+            static_cast<uint32_t>(m_stream), static_cast<uint32_t>(m_stream >> 32)};
+        uint32_t k0 = m_key[0];
+        uint32_t k1 = m_key[1];
+
+        for(int r=0; r<10; r++)
+        {
+            const uint64_t p0 = static_cast<uint64_t>(M0) * ctr[0];
+            const uint64_t p1 = static_cast<uint64_t>(M1) * ctr[2];
+            ctr = {
+                static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ k0, static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ k1, static_cast<uint32_t>(p0)};
+            k0 += W0;
+            k1 += W1;
+        }
+
+        return ctr;
+    }
+
+    /**
+     * Blocks [first, first + n) in structure-of-arrays layout: 
+     * word i of block first + j is written to xi[j].
+     * 
+     * Written for vectorization across blocks (omp simd).
+     */
+    inline void blocks(uint64_t first, size_t n, 
+        uint32_t* x0, uint32_t* x1, uint32_t* x2, uint32_t* x3) const
+    {
+        const uint32_t s0 = static_cast<uint32_t>(m_stream);
+        const uint32_t s1 = static_cast<uint32_t>(m_stream >> 32);
+        const uint32_t key0 = m_key[0];
+        const uint32_t key1 = m_key[1];
+
+        #pragma omp simd
+        for(size_t j=0; j<n; j++)
+        {
+            const uint64_t counter = first + j;
+            uint32_t c0 = static_cast<uint32_t>(counter);
+            uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+            uint32_t c2 = s0;
+            uint32_t c3 = s1;
+            uint32_t k0 = key0;
+            uint32_t k1 = key1;
+
+            for(int r=0; r<10; r++)
+            {
+                const uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+                const uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+                c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                c1 = static_cast<uint32_t>(p1);
+                c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                c3 = static_cast<uint32_t>(p0);
+                k0 += W0;
+                k1 += W1;
+            }
+
+            x0[j] = c0;
+            x1[j] = c1;
+            x2[j] = c2;
+            x3[j] = c3;
+        }
+    }
+
+    // sequential interface
+    result_type operator()()
+    {
+        if(m_index == 4)
+        {
+            m_buffer = block(m_counter++);
+            m_index = 0;
+        }
+        return m_buffer[m_index++];
+    }
+
+    // continue the sequential output at block index counter
+    void seek(uint64_t counter)
+    {
+        m_counter = counter;
+        m_index = 4;
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+private:
+    static constexpr uint32_t M0 = 0xD2511F53;
+    static constexpr uint32_t M1 = 0xCD9E8D57;
+    static constexpr uint32_t W0 = 0x9E3779B9;
+    static constexpr uint32_t W1 = 0xBB67AE85;
+
+    uint32_t m_key[2];
+    uint64_t m_stream;
+
+    uint64_t m_counter;
+    Block m_buffer;
+    int m_index;
+};
+
+/**
+ * Uniform double in [0, 1) from two 32 bit words (53 bit resolution)
+ */
+inline double to_unit(uint32_t a, uint32_t b)
+{
+    return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * High 64 bits of the 128 bit product a * b. With b = n and a uniform a,
+ * the result is uniform in [0, n) (multiply-shift, bias below n / 2^64)
+ */
+inline uint64_t mul_hi(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    return static_cast<uint64_t>((static_cast<uint128>(a) * b) >> 64);
+#else
+    const uint64_t a0 = static_cast<uint32_t>(a), a1 = a >> 32;
+    const uint64_t b0 = static_cast<uint32_t>(b), b1 = b >> 32;
+    const uint64_t p00 = a0 * b0;
+    const uint64_t p01 = a0 * b1;
+    const uint64_t p10 = a1 * b0;
+    const uint64_t p11 = a1 * b1;
+    const uint64_t mid = (p00 >> 32) + static_cast<uint32_t>(p01) + static_cast<uint32_t>(p10);
+    return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+// number of trailing zero bits of x, 64 for x = 0
+inline uint64_t count_trailing_zeros(uint64_t x)
+{
+    if(x == 0)
+    {
+        return 64;
+    }
+#if defined(__GNUC__)
+    return static_cast<uint64_t>(__builtin_ctzll(x));
+#else
+    uint64_t n = 0;
+    for(; (x & 1u) == 0; x >>= 1)
+    {
+        n++;
+    }
+    return n;
+#endif
+}
+
+} // namespace random
+
+} // namespace rosmath
+
+#endif // ROSMATH_RANDOM_PHILOX_H
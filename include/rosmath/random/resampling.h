@@ -0,0 +1,118 @@
+#ifndef ROSMATH_RANDOM_RESAMPLING_H
+#define ROSMATH_RANDOM_RESAMPLING_H
+
+#include <geometry_msgs/PoseArray.h>
+#include <vector>
+
+// internal deps
+#include "rosmath/random.h"
+
+namespace rosmath {
+
+namespace random {
+
+/**
+ * Resampling schemes, ordered by variance of the number of copies:
+ *
+ * MULTINOMIAL: i.i.d. draws from the weights
+ * STRATIFIED:  one draw in each of the strata [k, k + 1) / N
+ * SYSTEMATIC:  one offset shared by all strata (lowest variance in practice)
+ * RESIDUAL:    floor(N * w_i) deterministic copies, the rest multinomial
+ *
+ * All schemes walk the weights once with sorted uniforms: O(N + M).
+ *
+ * source: Douc, Cappe, Moulines - "Comparison of Resampling Schemes
+ *   for Particle Filtering", ISPA 2005
+ */
+enum class Resampling {
+    MULTINOMIAL,
+    STRATIFIED,
+    SYSTEMATIC,
+    RESIDUAL
+};
+
+/**
+ * 1 / sum(w_i^2) of the normalized weights. Resample when it drops
+ * below a fraction (e.g. 0.5) of the number of particles.
+ */
+double effective_sample_size(const std::vector<double>& weights);
+
+/**
+ * @brief Resampling with buffers reused across filter iterations
+ *
+ * After the first call with the largest particle count, resampling
+ * allocates no memory. Weights need not be normalized, but must be
+ * non-negative with a positive sum (std::runtime_error otherwise).
+ *
+ * Not thread-safe: use one Resampler per thread.
+ */
+class Resampler {
+public:
+    Resampler(const Resampling method = Resampling::SYSTEMATIC);
+
+    Resampling method() const;
+
+    /**
+     * size indices of the drawn particles into indices (resized)
+     */
+    void resample(
+        Engine& gen,
+        const std::vector<double>& weights,
+        const size_t size,
+        std::vector<size_t>& indices);
+
+    void resample(
+        const std::vector<double>& weights,
+        const size_t size,
+        std::vector<size_t>& indices);
+
+    /**
+     * Resample the poses of particles in place, weights[i] belongs to
+     * particles.poses[i]. The number of particles is kept.
+     */
+    void resample(
+        Engine& gen,
+        const std::vector<double>& weights,
+        geometry_msgs::PoseArray& particles);
+
+    void resample(
+        const std::vector<double>& weights,
+        geometry_msgs::PoseArray& particles);
+
+private:
+    Resampling m_method;
+
+    // sorted uniforms (multinomial), residual weights, indices, poses
+    std::vector<double> m_uniforms;
+    std::vector<double> m_residuals;
+    std::vector<size_t> m_indices;
+    std::vector<geometry_msgs::Pose> m_poses;
+};
+
+std::vector<size_t> resample(
+    Engine& gen,
+    const std::vector<double>& weights,
+    const size_t size,
+    const Resampling method = Resampling::SYSTEMATIC);
+
+std::vector<size_t> resample(
+    const std::vector<double>& weights,
+    const size_t size,
+    const Resampling method = Resampling::SYSTEMATIC);
+
+geometry_msgs::PoseArray resample(
+    Engine& gen,
+    const geometry_msgs::PoseArray& particles,
+    const std::vector<double>& weights,
+    const Resampling method = Resampling::SYSTEMATIC);
+
+geometry_msgs::PoseArray resample(
+    const geometry_msgs::PoseArray& particles,
+    const std::vector<double>& weights,
+    const Resampling method = Resampling::SYSTEMATIC);
+
+} // namespace random
+
+} // namespace rosmath
+
+#endif // ROSMATH_RANDOM_RESAMPLING_H
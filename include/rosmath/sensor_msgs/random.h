@@ -0,0 +1,119 @@
+#ifndef ROSMATH_SENSOR_MSGS_RANDOM_H
+#define ROSMATH_SENSOR_MSGS_RANDOM_H
+
+#include <sensor_msgs/LaserScan.h>
+#include <sensor_msgs/PointCloud.h>
+#include <geometry_msgs/Pose.h>
+
+// internal deps
+#include "rosmath/random.h"
+
+namespace rosmath {
+
+namespace random {
+
+/**
+ * Planar scanner in a rectangular room (walls at +-room_x/2, +-room_y/2
+ * around the origin). The sensor is placed at (x, y) with heading yaw.
+ *
+ * Ranges get Gaussian noise; with probability dropout a beam has no
+ * return (+inf, REP 117) as well as beams beyond range_max.
+ * Intensities fall off with range.
+ */
+struct LaserScanParams {
+    size_t beams = 720;
+    float angle_min = -M_PI;
+    float angle_max = M_PI;
+    float range_min = 0.1;
+    float range_max = 30.0;
+    // scan period in seconds, sets time_increment
+    float scan_time = 0.025;
+
+    double room_x = 10.0;
+    double room_y = 6.0;
+    double x = 0.0;
+    double y = 0.0;
+    double yaw = 0.0;
+
+    double range_sigma = 0.01;
+    double dropout = 0.01;
+
+    bool intensities = true;
+    double intensity_scale = 1000.0;
+    double intensity_sigma = 10.0;
+};
+
+enum class Surface {
+    PLANE,  // square of side size in the xy-plane, normals +z
+    SPHERE, // sphere of diameter size, outward normals
+    BOX     // surface of a cube of side size, outward normals
+};
+
+/**
+ * Points sampled uniformly on a surface, placed at pose, with isotropic
+ * Gaussian noise. Normals are stored in the channels nx, ny, nz
+ * (see hasNormals).
+ */
+struct PointCloudParams {
+    PointCloudParams()
+    {
+        pose.orientation.w = 1.0;
+    }
+
+    size_t points = 10000;
+    Surface surface = Surface::PLANE;
+    double size = 1.0;
+    geometry_msgs::Pose pose;
+    double sigma = 0.005;
+    bool normals = true;
+};
+
+/**
+ * The *_fill versions reuse the memory of the message for streams at full
+ * rate. Headers are not touched: set frame_id and stamp.
+ *
+ * Philox versions: a scan consumes 3 * beams elements after offset, a
+ * cloud 6 * points elements. Use one stream per virtual sensor and advance
+ * the offset per message to get reproducible independent streams.
+ */
+void laser_scan_fill(
+    const Philox& gen,
+    sensor_msgs::LaserScan& scan,
+    const LaserScanParams& params,
+    const size_t offset = 0);
+
+void laser_scan_fill(
+    sensor_msgs::LaserScan& scan,
+    const LaserScanParams& params);
+
+sensor_msgs::LaserScan laser_scan(
+    const Philox& gen,
+    const LaserScanParams& params,
+    const size_t offset = 0);
+
+sensor_msgs::LaserScan laser_scan(
+    const LaserScanParams& params);
+
+void point_cloud_fill(
+    const Philox& gen,
+    sensor_msgs::PointCloud& pcl,
+    const PointCloudParams& params,
+    const size_t offset = 0);
+
+void point_cloud_fill(
+    sensor_msgs::PointCloud& pcl,
+    const PointCloudParams& params);
+
+sensor_msgs::PointCloud point_cloud(
+    const Philox& gen,
+    const PointCloudParams& params,
+    const size_t offset = 0);
+
+sensor_msgs::PointCloud point_cloud(
+    const PointCloudParams& params);
+
+} // namespace random
+
+} // namespace rosmath
+
+#endif // ROSMATH_SENSOR_MSGS_RANDOM_H
@@ -0,0 +1,137 @@
+#ifndef ROSMATH_SENSOR_MSGS_SAMPLING_H
+#define ROSMATH_SENSOR_MSGS_SAMPLING_H
+
+#include <sensor_msgs/PointCloud.h>
+#include <unordered_map>
+#include <vector>
+
+// internal deps
+#include "rosmath/random.h"
+
+namespace rosmath {
+
+namespace random {
+
+/**
+ * @brief Uniform random subset of fixed size of a point cloud stream
+ *
+ * Single pass over chunks of any size. Every point gets an implicit
+ * uniform key and the reservoir keeps the points with the smallest keys.
+ * The number of points to skip before the next replacement is drawn
+ * directly (geometric jumps), so points that are not sampled are never
+ * touched.
+ *
+ * Samplers over disjoint parts of a cloud (e.g. one per thread) can be
+ * merged into a sample of the union. Channels stay aligned with the
+ * points; all chunks must have the same channels.
+ *
+ * source: Li - "Reservoir-Sampling Algorithms of Time Complexity
+ *   O(n(1 + log(N/n)))", ACM TOMS 1994
+ */
+class ReservoirSampler {
+public:
+    ReservoirSampler(const size_t capacity, const uint64_t seed = 0);
+
+    // points [begin, end) of cloud
+    void add(const sensor_msgs::PointCloud& cloud, const size_t begin, const size_t end);
+    void add(const sensor_msgs::PointCloud& cloud);
+
+    // other must have the same capacity
+    void merge(const ReservoirSampler& other);
+
+    size_t capacity() const;
+    // number of points added
+    size_t seen() const;
+    size_t size() const;
+
+    // the sampled points and channels (header of the first chunk)
+    const sensor_msgs::PointCloud& cloud() const;
+
+    void clear();
+
+private:
+    void replace(const size_t slot, const double key);
+    void drawSkip();
+
+    size_t m_capacity;
+    size_t m_seen;
+    size_t m_skip;
+    Engine m_gen;
+
+    sensor_msgs::PointCloud m_samples;
+    std::vector<double> m_keys;
+    // max-heap of slots ordered by key
+    std::vector<size_t> m_heap;
+};
+
+/**
+ * @brief One random point per voxel of a point cloud stream
+ *
+ * Each occupied voxel of side cell_size keeps a uniformly chosen point
+ * of the points that fell into it (a reservoir of size one per voxel).
+ * Streaming over chunks and mergeable like ReservoirSampler. Points are
+ * ordered by the first appearance of their voxel.
+ */
+class StratifiedSampler {
+public:
+    StratifiedSampler(const double cell_size, const uint64_t seed = 0);
+
+    void add(const sensor_msgs::PointCloud& cloud, const size_t begin, const size_t end);
+    void add(const sensor_msgs::PointCloud& cloud);
+
+    // other must have the same cell size
+    void merge(const StratifiedSampler& other);
+
+    double cellSize() const;
+    size_t seen() const;
+    // number of occupied voxels
+    size_t size() const;
+
+    const sensor_msgs::PointCloud& cloud() const;
+
+    void clear();
+
+private:
+    struct Cell {
+        size_t count;
+        size_t slot;
+    };
+
+    int64_t key(const geometry_msgs::Point32& p) const;
+
+    double m_cell_size;
+    size_t m_seen;
+    Engine m_gen;
+
+    sensor_msgs::PointCloud m_samples;
+    std::unordered_map<int64_t, Cell> m_cells;
+};
+
+/**
+ * Subsampling of a whole cloud. Chunks are sampled in parallel (OpenMP)
+ * and merged. Chunk seeds are drawn from gen beforehand, so the result
+ * does not depend on the number of threads.
+ */
+sensor_msgs::PointCloud reservoir_sample(
+    Engine& gen,
+    const sensor_msgs::PointCloud& cloud,
+    const size_t size);
+
+sensor_msgs::PointCloud reservoir_sample(
+    const sensor_msgs::PointCloud& cloud,
+    const size_t size);
+
+sensor_msgs::PointCloud stratified_sample(
+    Engine& gen,
+    const sensor_msgs::PointCloud& cloud,
+    const double cell_size);
+
+sensor_msgs::PointCloud stratified_sample(
+    const sensor_msgs::PointCloud& cloud,
+    const double cell_size);
+
+} // namespace random
+
+} // namespace rosmath
+
+#endif // ROSMATH_SENSOR_MSGS_SAMPLING_H
@@ -4,6 +4,8 @@
 #include "math.h"
 #include <random>
 #include <cmath>
+#include <array>
+#include <vector>
 
 namespace rosmath {
 
@@ -11,6 +13,158 @@ namespace stats {
 
 constexpr static double SQRT2PI = std::sqrt(2 * M_PI);
 
+/**
+ * Scales the median absolute deviation to a consistent
+ * estimator of the standard deviation of normally distributed data:
+ * sigma ~= MAD_TO_SIGMA * mad
+ */
+constexpr static double MAD_TO_SIGMA = 1.482602218505602;
+
+/**
+ * @brief Streaming quantile sketch (merging t-digest)
+ * 
+ * source: Dunning, Ertl - "Computing Extremely Accurate Quantiles Using t-Digests"
+ * 
+ * Memory is bounded by the compression parameter: at most ~2*compression
+ * centroids plus an insertion buffer are kept, independent of the number 
+ * of added values. Digests filled by different threads can be combined 
+ * with merge().
+ * 
+ * Note: const queries compress pending insertions lazily. Do not query 
+ * one digest from several threads while it is still being filled.
+ */
+class TDigest {
+public:
+    TDigest(const double compression = 100.0);
+
+    void add(const double x, const double w = 1.0);
+
+    void add(const std::vector<double>& data);
+
+    /**
+     * Merge another digest into this one, e.g. 
+     * a digest that was filled in a different thread
+     */
+    void merge(const TDigest& other);
+
+    /**
+     * Approximate q-quantile, q in [0,1]
+     */
+    double quantile(const double q) const;
+
+    /**
+     * Approximate fraction of values <= x
+     */
+    double cdf(const double x) const;
+
+    double median() const;
+
+    double count() const;
+    double min() const;
+    double max() const;
+
+    // number of centroids after compression
+    size_t size() const;
+
+    void clear();
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    void compress() const;
+
+    double m_compression;
+    double m_min;
+    double m_max;
+
+    mutable std::vector<Centroid> m_centroids;
+    mutable std::vector<Centroid> m_buffer;
+    mutable double m_weight;
+};
+
+/**
+ * @brief Rolling mean and covariance over the latest stamped points/poses
+ * 
+ * The window is bounded by time (duration relative to the newest stamp), 
+ * by count (max_size) or both. A value of zero disables the bound.
+ * 
+ * Samples are kept in a ring buffer. Sums are stored relative to an anchor
+ * point so each insertion and eviction is O(1). The anchor is moved to
+ * the current mean periodically (amortized O(1)) to bound the cancellation 
+ * error of the subtracted sums.
+ * 
+ * For PoseStamped the orientation is averaged by summing sign-aligned 
+ * quaternions, which is accurate for small angular spread.
+ * 
+ * Samples are expected in chronological order.
+ */
+class SlidingWindow {
+public:
+    SlidingWindow(
+        const ros::Duration& duration,
+        const size_t max_size = 0);
+
+    SlidingWindow(
+        const size_t max_size);
+
+    void add(const ros::Time& stamp, const geometry_msgs::Point& p);
+    void add(const ros::Time& stamp, const geometry_msgs::Pose& p);
+    void add(const geometry_msgs::PointStamped& p);
+    void add(const geometry_msgs::PoseStamped& p);
+
+    /**
+     * Evict samples that are older than stamp - duration.
+     * Called automatically on each insertion with the new stamp.
+     */
+    void evict(const ros::Time& stamp);
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    ros::Time oldest() const;
+    ros::Time newest() const;
+
+    geometry_msgs::Point mean() const;
+    geometry_msgs::Point variance() const;
+    Eigen::Matrix3d covariance() const;
+    geometry_msgs::Quaternion orientation() const;
+
+private:
+    struct Sample {
+        ros::Time stamp;
+        Eigen::Vector3d p;
+        Eigen::Vector4d q;
+    };
+
+    void push(const ros::Time& stamp, 
+        const Eigen::Vector3d& p, 
+        const Eigen::Vector4d& q);
+    void pop();
+    void reanchor();
+
+    const Sample& at(size_t i) const;
+
+    ros::Duration m_duration;
+    size_t m_max_size;
+
+    // ring buffer
+    std::vector<Sample> m_samples;
+    size_t m_head;
+    size_t m_size;
+
+    // sums relative to anchor
+    Eigen::Vector3d m_anchor;
+    Eigen::Vector3d m_sum;
+    Eigen::Matrix3d m_sum_sq;
+    Eigen::Vector4d m_q_anchor;
+    Eigen::Vector4d m_q_sum;
+    size_t m_updates;
+};
+
 } // namespace stats
 
 template<typename ...Tp>
@@ -65,6 +219,32 @@ struct PointCovariance {
     Eigen::Matrix3d covariance;
 };
 
+struct PointMedian {
+    geometry_msgs::Point median;
+};
+
+// median absolute deviation
+struct PointMAD {
+    geometry_msgs::Point mad;
+};
+
+// streaming quantile sketches for x, y and z
+struct PointQuantiles {
+    std::array<stats::TDigest, 3> quantiles;
+};
+
+/**
+ * @brief Principal components of a 3D point set
+ * 
+ * eigenvalues are sorted in ascending order. The i-th column 
+ * of eigenvectors is the axis belonging to the i-th eigenvalue,
+ * i.e. column 2 is the main direction and column 0 the normal
+ */
+struct PCA {
+    Eigen::Vector3d eigenvalues;
+    Eigen::Matrix3d eigenvectors;
+};
+
 double mean(
     const std::vector<double>& data);
 
@@ -94,9 +274,111 @@ Eigen::Matrix3d covariance(
 Eigen::Matrix3d covariance(
     const std::vector<geometry_msgs::Point>& points);
 
+/**
+ * Eigen decomposition of a symmetric 3x3 (covariance) matrix.
+ * Uses the closed-form solver instead of the iterative one
+ */
+PCA pca(
+    const Eigen::Matrix3d& cov);
+
+PCA pca(
+    const std::vector<geometry_msgs::Point>& points);
+
+/**
+ * Batched local PCA. Computes the PCA of each neighborhood, 
+ * given as indices into points. Neighborhoods are processed 
+ * in parallel if OpenMP is available.
+ * 
+ * Neighborhoods with less than 3 points get zero eigenvalues.
+ */
 void pca(
+    const std::vector<geometry_msgs::Point>& points,
+    const std::vector<std::vector<size_t> >& neighborhoods,
+    std::vector<PCA>& result);
+
+std::vector<PCA> pca(
+    const std::vector<geometry_msgs::Point>& points,
+    const std::vector<std::vector<size_t> >& neighborhoods);
+
+/**
+ * Shape features from eigenvalues l1 >= l2 >= l3:
+ * - linearity: (l1 - l2) / l1
+ * - planarity: (l2 - l3) / l1
+ * - scattering: l3 / l1
+ */
+double linearity(const PCA& pca);
+double planarity(const PCA& pca);
+double scattering(const PCA& pca);
+
+/**
+ * Exact q-quantile with linear interpolation between order statistics.
+ * Selection (nth_element) is done on the scratch buffer, which 
+ * can be reused across calls to avoid allocations.
+ */
+double quantile(
+    const std::vector<double>& data,
+    const double q,
+    std::vector<double>& buffer);
+
+double quantile(
+    const std::vector<double>& data,
+    const double q);
+
+double median(
+    const std::vector<double>& data,
+    std::vector<double>& buffer);
+
+double median(
+    const std::vector<double>& data);
+
+/**
+ * Median absolute deviation: median(|x_i - median(x)|)
+ * 
+ * Multiply with stats::MAD_TO_SIGMA to get a robust estimate of the 
+ * standard deviation.
+ */
+double mad(
+    const std::vector<double>& data,
+    const double median,
+    std::vector<double>& buffer);
+
+double mad(
+    const std::vector<double>& data,
+    std::vector<double>& buffer);
+
+double mad(
+    const std::vector<double>& data);
+
+// per coordinate. the coordinates are copied into the scratch buffer one 
+// after another, so no further memory is allocated
+geometry_msgs::Point quantile(
+    const std::vector<geometry_msgs::Point>& points,
+    const double q,
+    std::vector<double>& buffer);
+
+geometry_msgs::Point quantile(
+    const std::vector<geometry_msgs::Point>& points,
+    const double q);
+
+geometry_msgs::Point median(
+    const std::vector<geometry_msgs::Point>& points,
+    std::vector<double>& buffer);
+
+geometry_msgs::Point median(
+    const std::vector<geometry_msgs::Point>& points);
+
+geometry_msgs::Point mad(
+    const std::vector<geometry_msgs::Point>& points,
+    const geometry_msgs::Point median,
+    std::vector<double>& buffer);
+
+geometry_msgs::Point mad(
     const std::vector<geometry_msgs::Point>& points);
 
+geometry_msgs::Point quantile(
+    const PointQuantiles& sketch,
+    const double q);
+
 template<typename ...Tp>
 Stats<Tp...> calculate_stats(
     const std::vector<geometry_msgs::Point>& points)
@@ -134,6 +416,36 @@ Stats<Tp...> calculate_stats(
             ret.covariance = covariance(points);
         }
     }
+
+    // calculate median and median absolute deviation
+    if constexpr(StatsType::template has<PointMedian>() 
+        || StatsType::template has<PointMAD>())
+    {
+        // shared scratch buffer for selection
+        std::vector<double> buffer(points.size());
+        geometry_msgs::Point pmedian = median(points, buffer);
+
+        if constexpr(StatsType::template has<PointMedian>())
+        {
+            ret.median = pmedian;
+        }
+
+        if constexpr(StatsType::template has<PointMAD>())
+        {
+            ret.mad = mad(points, pmedian, buffer);
+        }
+    }
+
+    // fill quantile sketches
+    if constexpr(StatsType::template has<PointQuantiles>())
+    {
+        for(const geometry_msgs::Point& p : points)
+        {
+            ret.quantiles[0].add(p.x);
+            ret.quantiles[1].add(p.y);
+            ret.quantiles[2].add(p.z);
+        }
+    }
     
     return ret;
 }
@@ -1,5 +1,6 @@
 #include <ros/ros.h>
 #include <rosmath/rosmath.h>
+#include <rosmath/eigen/map.h>
 #include <iostream>
 
 using namespace rosmath;
@@ -145,6 +146,199 @@ bool testPointEigen()
 }
 
 
+bool testEigenMap()
+{
+    bool ret = true;
+
+    std::vector<geometry_msgs::Point> points(4);
+    for(size_t i=0; i<points.size(); i++)
+    {
+        points[i].x = i;
+        points[i].y = 10.0 * i;
+        points[i].z = 100.0 * i;
+    }
+
+    // views share the memory of the messages
+    PointsMap P = eigen_map(points);
+    ret &= P.rows() == 4 && P(2, 0) == 2.0 && P(2, 1) == 20.0 && P(3, 2) == 300.0;
+    P.col(2).array() += 1.0;
+    ret &= points[1].z == 101.0;
+    const std::vector<geometry_msgs::Point>& cpoints = points;
+    ret &= eigen_map(cpoints).colwise().sum() == Eigen::RowVector3d(6.0, 60.0, 604.0);
+
+    sensor_msgs::PointCloud cloud;
+    cloud.points.resize(3);
+    cloud.points[2].y = 5.0f;
+    Points32Map Q = eigen_map(cloud);
+    ret &= Q.rows() == 3 && Q(2, 1) == 5.0f;
+    Q.row(0) << 1.0f, 2.0f, 3.0f;
+    ret &= cloud.points[0].x == 1.0f && cloud.points[0].y == 2.0f && cloud.points[0].z == 3.0f;
+
+    // row-major like the message
+    boost::array<double, 36> cov;
+    for(size_t i=0; i<36; i++)
+    {
+        cov[i] = i;
+    }
+    CovarianceMap C = eigen_map(cov);
+    ret &= C(1, 2) == 8.0 && C(5, 0) == 30.0;
+    C.transposeInPlace();
+    ret &= cov[8] == 13.0;
+
+    std::vector<geometry_msgs::Point> empty;
+    ret &= eigen_map(empty).rows() == 0;
+
+    return ret;
+}
+
+bool testContainers()
+{
+    bool ret = true;
+
+    std::vector<geometry_msgs::Point> points(5);
+    for(size_t i=0; i<points.size(); i++)
+    {
+        points[i].x = i;
+        points[i].y = -1.0 * i;
+        points[i].z = 0.5 * i;
+    }
+
+    Eigen::Matrix3Xd P;
+    P <<= points;
+    ret &= P.cols() == 5 && P(0, 3) == 3.0 && P(1, 3) == -3.0 && P(2, 4) == 2.0;
+    Eigen::Matrix3Xf Pf;
+    Pf <<= points;
+    ret &= Pf.cols() == 5 && Pf(2, 4) == 2.0f;
+
+    std::vector<geometry_msgs::Point> points2;
+    points2 <<= P;
+    std::vector<geometry_msgs::Point32> points32;
+    points32 <<= Pf;
+    ret &= points2.size() == 5 && points2[4].x == 4.0 && points2[4].z == 2.0;
+    ret &= points32.size() == 5 && points32[4].y == -4.0f;
+    Eigen::Matrix3Xd P32;
+    P32 <<= points32;
+    ret &= P32 == P;
+
+    std::vector<geometry_msgs::Pose> poses(3);
+    for(size_t i=0; i<poses.size(); i++)
+    {
+        const Eigen::Quaterniond q(Eigen::AngleAxisd(0.3 * i, Eigen::Vector3d(1.0, 2.0, 3.0).normalized()));
+        poses[i].position.x = i;
+        poses[i].position.y = 2.0;
+        poses[i].position.z = -1.0;
+        poses[i].orientation.x = q.x();
+        poses[i].orientation.y = q.y();
+        poses[i].orientation.z = q.z();
+        poses[i].orientation.w = q.w();
+    }
+
+    Isometry3dVector T;
+    T <<= poses;
+    Eigen::Affine3d A;
+    A <<= poses[2];
+    ret &= T.size() == 3 && T[2].isApprox(Eigen::Isometry3d(A.matrix()));
+
+    std::vector<geometry_msgs::Pose> poses2;
+    poses2 <<= T;
+    for(size_t i=0; i<poses.size(); i++)
+    {
+        const double sign = (poses2[i].orientation.w * poses[i].orientation.w < 0.0) ? -1.0 : 1.0;
+        ret &= std::fabs(poses2[i].position.x - poses[i].position.x) < 1e-12;
+        ret &= std::fabs(sign * poses2[i].orientation.z - poses[i].orientation.z) < 1e-12;
+    }
+
+    // x y z qx qy qz qw
+    Matrix7Xd M;
+    M <<= poses;
+    ret &= M.cols() == 3 && M(0, 1) == 1.0 && M(1, 1) == 2.0 && M(6, 2) == poses[2].orientation.w;
+
+    nav_msgs::Path path;
+    path.header.frame_id = "map";
+    path <<= M;
+    ret &= path.poses.size() == 3 && path.header.frame_id == "map" 
+        && path.poses[2].pose.orientation.x == poses[2].orientation.x;
+    Matrix7Xd M2;
+    M2 <<= path;
+    Isometry3dVector T2;
+    T2 <<= path;
+    ret &= M2 == M && T2.size() == 3 && T2[1].isApprox(T[1]);
+
+    std::vector<geometry_msgs::Point> empty;
+    P <<= empty;
+    ret &= P.cols() == 0;
+
+    return ret;
+}
+
+bool testOpenCVPoints()
+{
+    bool ret = true;
+
+    sensor_msgs::PointCloud cloud;
+    cloud.points.resize(4);
+    for(size_t i=0; i<cloud.points.size(); i++)
+    {
+        cloud.points[i].x = i;
+        cloud.points[i].y = 2.0f * i;
+        cloud.points[i].z = -1.0f;
+    }
+
+    // header on the points
+    cv::Mat view = wrap(cloud);
+    ret &= view.rows == 4 && view.cols == 3 && view.type() == CV_32F;
+    view.at<float>(2, 1) = 7.0f;
+    ret &= cloud.points[2].y == 7.0f;
+
+    cv::Mat copy;
+    convert(cloud, copy);
+    copy.at<float>(3, 0) = 0.0f;
+    ret &= copy.rows == 4 && copy.at<float>(1, 1) == 2.0f && cloud.points[3].x == 3.0f;
+
+    std::vector<geometry_msgs::Point32> points;
+    convert(copy, points);
+    ret &= points.size() == 4 && points[3].x == 0.0f && points[2].y == 7.0f;
+
+    std::vector<cv::Point3f> cv_points;
+    convert(cloud, cv_points);
+    ret &= cv_points.size() == 4 && cv_points[1].y == 2.0f;
+    std::vector<geometry_msgs::Point> points64;
+    convert(cv_points, points64);
+    ret &= points64.size() == 4 && points64[1].y == 2.0 && points64[0].z == -1.0;
+
+    cv::Mat mat64;
+    convert(points64, mat64);
+    ret &= mat64.type() == CV_64F && mat64.at<double>(2, 1) == 7.0;
+
+    // the output does not write into matrices sharing the previous data
+    cv::Mat shared = mat64;
+    points64[2].y = 8.0;
+    convert(points64, mat64);
+    ret &= shared.at<double>(2, 1) == 7.0 && mat64.at<double>(2, 1) == 8.0;
+
+    // 3 x 3 view of a larger matrix, rows are not contiguous
+    cv::Mat big(4, 5, CV_64F);
+    for(int i=0; i<big.rows; i++)
+    {
+        for(int j=0; j<big.cols; j++)
+        {
+            big.at<double>(i, j) = 10.0 * i + j;
+        }
+    }
+    Eigen::Matrix3d R;
+    convert(big(cv::Range(1, 4), cv::Range(1, 4)), R);
+    ret &= R(0, 0) == 11.0 && R(1, 0) == 21.0 && R(2, 2) == 33.0;
+
+    try {
+        convert(cv::Mat(3, 1, CV_64F), R);
+        ret = false;
+    } catch(const std::runtime_error& ex) {
+
+    }
+
+    return ret;
+}
+
 bool testTransform()
 {
     bool ret = true;
@@ -185,6 +379,9 @@ int main(int argc, char** argv)
 
     test("Internal", testInternal);
     test("Point Eigen", testPointEigen);
+    test("Eigen Map", testEigenMap);
+    test("Containers", testContainers);
+    test("OpenCV Points", testOpenCVPoints);
     test("Transform", testTransform);
     test("sensor_msgs", testSensorMsgs);
     
@@ -0,0 +1,699 @@
+#include <ros/ros.h>
+#include <rosmath/rosmath.h>
+#include <rosmath/random.h>
+#include <rosmath/random/resampling.h>
+#include <rosmath/sensor_msgs/random.h>
+#include <rosmath/sensor_msgs/sampling.h>
+#include <rosmath/eigen/stats.h>
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+using namespace rosmath;
+
+bool testEngines()
+{
+    bool ret = true;
+
+    // seed() resets the engine of this thread in all translation units
+    random::seed(42);
+    std::vector<double> a = random::uniform_numbers(0.0, 1.0, 100);
+    Eigen::Vector3d sa = stats::Normal3(Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity()).sample();
+
+    random::seed(42);
+    std::vector<double> b = random::uniform_numbers(0.0, 1.0, 100);
+    Eigen::Vector3d sb = stats::Normal3(Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity()).sample();
+
+    if(a != b || sa != sb)
+    {
+        ROS_WARN_STREAM("error: seed not reproducible");
+        ret = false;
+    }
+
+    // explicit engines
+    random::Engine e1(7), e2(7);
+    if(random::normal_numbers(e1, 0.0, 1.0, 100) != random::normal_numbers(e2, 0.0, 1.0, 100))
+    {
+        ROS_WARN_STREAM("error: explicit engine");
+        ret = false;
+    }
+
+    // threads get different streams
+    random::seed(42);
+    std::vector<double> t1, t2;
+    std::thread th1([&t1](){ t1 = random::uniform_numbers(0.0, 1.0, 10); });
+    th1.join();
+    std::thread th2([&t2](){ t2 = random::uniform_numbers(0.0, 1.0, 10); });
+    th2.join();
+    if(t1 == t2)
+    {
+        ROS_WARN_STREAM("error: thread engines are not independent");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testPhilox()
+{
+    bool ret = true;
+
+    // known answers of the reference implementation (Random123)
+    random::Philox zero(0, 0);
+    random::Philox::Block b0 = zero.block(0);
+    if(b0[0] != 0x6627e8d5 || b0[1] != 0xe169c58d || b0[2] != 0xbc57ac4c || b0[3] != 0x9b00dbd8)
+    {
+        ROS_WARN_STREAM("error: philox known answer " << std::hex << b0[0] << " " << b0[1] << " " << b0[2] << " " << b0[3]);
+        ret = false;
+    }
+
+    // chunks equal the full sample
+    random::Philox gen(1234, 7);
+    std::vector<double> full = random::normal_numbers(gen, 0.0, 1.0, 10001);
+    std::vector<double> chunk = random::normal_numbers(gen, 0.0, 1.0, 1001, 4567);
+    for(size_t i=0; i<chunk.size(); i++)
+    {
+        if(chunk[i] != full[4567 + i])
+        {
+            ROS_WARN_STREAM("error: philox chunk at " << i);
+            ret = false;
+            break;
+        }
+    }
+
+    geometry_msgs::Point pmin, pmax;
+    pmax.x = pmax.y = pmax.z = 1.0;
+    std::vector<geometry_msgs::Point> pts = random::uniform_points(gen, pmin, pmax, 100);
+    std::vector<geometry_msgs::Point> pts_chunk = random::uniform_points(gen, pmin, pmax, 10, 33);
+    if(pts_chunk[0].x != pts[33].x || pts_chunk[9].z != pts[42].z)
+    {
+        ROS_WARN_STREAM("error: philox point chunk");
+        ret = false;
+    }
+
+    // moments
+    double mean = std::accumulate(full.begin(), full.end(), 0.0) / full.size();
+    double var = 0.0;
+    for(double v : full)
+    {
+        var += (v - mean) * (v - mean);
+    }
+    var /= full.size();
+    if(std::fabs(mean) > 0.05 || std::fabs(var - 1.0) > 0.05)
+    {
+        ROS_WARN_STREAM("error: philox normal moments " << mean << ", " << var);
+        ret = false;
+    }
+
+    std::vector<size_t> idx(1000);
+    random::uniform_fill(gen, idx, 3, 5);
+    if(*std::min_element(idx.begin(), idx.end()) != 3 || *std::max_element(idx.begin(), idx.end()) != 5)
+    {
+        ROS_WARN_STREAM("error: philox integer range");
+        ret = false;
+    }
+
+    // different streams differ
+    if(random::Philox(1234, 8).block(0) == gen.block(0))
+    {
+        ROS_WARN_STREAM("error: philox streams");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testBulk()
+{
+    bool ret = true;
+
+    random::Philox gen(99, 1);
+
+    // raw buffers, vectors and matrices share the element mapping
+    std::vector<double> v = random::normal_numbers(gen, 1.0, 2.0, 1000);
+    std::vector<double> raw(1000);
+    random::normal_fill(gen, raw.data(), raw.size(), 1.0, 2.0);
+    Eigen::MatrixXd M(10, 100);
+    random::normal_fill(gen, M, 1.0, 2.0);
+
+    // odd offsets start in the middle of a block
+    Eigen::MatrixXd M_chunk(3, 7);
+    random::normal_fill(gen, M_chunk, 1.0, 2.0, 501);
+
+    if(v != raw || std::fabs(M(3, 17) - v[173]) > 0.0 || std::fabs(M_chunk(2, 4) - v[501 + 14]) > 0.0)
+    {
+        ROS_WARN_STREAM("error: bulk element mapping");
+        ret = false;
+    }
+
+    // moments of thread engine bulk samples
+    std::vector<double> u(100000);
+    random::uniform_fill(u.data(), u.size(), -1.0, 3.0);
+    const double mean = std::accumulate(u.begin(), u.end(), 0.0) / u.size();
+    if(std::fabs(mean - 1.0) > 0.02 
+        || *std::min_element(u.begin(), u.end()) < -1.0 
+        || *std::max_element(u.begin(), u.end()) >= 3.0)
+    {
+        ROS_WARN_STREAM("error: bulk uniform");
+        ret = false;
+    }
+
+    // Normal_::samples uses the bulk generator
+    Eigen::Matrix2d cov;
+    cov << 2.0, 0.5, 0.5, 1.0;
+    stats::Normal2 N(Eigen::Vector2d(1.0, -1.0), cov);
+    stats::Normal2 fitted = stats::Normal2::fit(N.samples(100000));
+    if((fitted.mean() - N.mean()).norm() > 0.03 || (fitted.cov() - N.cov()).norm() > 0.05)
+    {
+        ROS_WARN_STREAM("error: bulk normal samples\n" << fitted.cov());
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testPoses()
+{
+    bool ret = true;
+
+    // uniform orientations: unit length, E[q_i^2] = 1/4
+    std::vector<geometry_msgs::Quaternion> qs(100000);
+    random::uniform_fill(qs);
+    Eigen::Vector4d m2 = Eigen::Vector4d::Zero();
+    double max_err = 0.0;
+    for(const auto& q : qs)
+    {
+        Eigen::Vector4d v(q.x, q.y, q.z, q.w);
+        max_err = std::max(max_err, std::fabs(v.norm() - 1.0));
+        m2 += v.cwiseProduct(v);
+    }
+    m2 /= qs.size();
+    if(max_err > 1e-12 || (m2 - Eigen::Vector4d::Constant(0.25)).cwiseAbs().maxCoeff() > 0.01)
+    {
+        ROS_WARN_STREAM("error: uniform quaternions " << max_err << " " << m2.transpose());
+        ret = false;
+    }
+
+    // rotations about an axis, single and batch
+    geometry_msgs::Vector3 axis;
+    axis.x = 1.0; axis.y = 2.0; axis.z = 2.0;
+    std::vector<geometry_msgs::Quaternion> qa(100);
+    random::uniform_fill(qa, axis);
+    qa.push_back(random::uniform_quaternion(axis));
+    for(const auto& q : qa)
+    {
+        Eigen::Vector3d v(q.x, q.y, q.z);
+        if(v.cross(Eigen::Vector3d(1.0, 2.0, 2.0)).norm() > 1e-12 
+            || std::fabs(v.squaredNorm() + q.w * q.w - 1.0) > 1e-12)
+        {
+            ROS_WARN_STREAM("error: axis quaternion");
+            ret = false;
+            break;
+        }
+    }
+
+    // pose chunks equal the full sample
+    random::Philox gen(5, 3);
+    geometry_msgs::Point pmin, pmax;
+    pmin.x = -10.0; pmin.y = -5.0; pmin.z = 0.0;
+    pmax.x = 10.0; pmax.y = 5.0; pmax.z = 1.0;
+    geometry_msgs::PoseArray full;
+    full.poses.resize(100);
+    random::uniform_fill(gen, full, pmin, pmax);
+    std::vector<geometry_msgs::Pose> chunk(10);
+    random::uniform_fill(gen, chunk, pmin, pmax, 6 * 40);
+    for(size_t i=0; i<chunk.size(); i++)
+    {
+        const geometry_msgs::Pose& a = chunk[i];
+        const geometry_msgs::Pose& b = full.poses[40 + i];
+        if(a.position.x != b.position.x || a.position.z != b.position.z 
+            || a.orientation.x != b.orientation.x || a.orientation.w != b.orientation.w)
+        {
+            ROS_WARN_STREAM("error: pose chunk at " << i);
+            ret = false;
+            break;
+        }
+    }
+    for(const auto& p : full.poses)
+    {
+        if(p.position.x < pmin.x || p.position.x >= pmax.x 
+            || p.position.y < pmin.y || p.position.y >= pmax.y
+            || p.position.z < pmin.z || p.position.z >= pmax.z)
+        {
+            ROS_WARN_STREAM("error: pose out of bounds");
+            ret = false;
+            break;
+        }
+    }
+
+    // gaussian poses around a mean
+    geometry_msgs::Transform mean;
+    mean.translation.x = 1.0;
+    mean.translation.y = 2.0;
+    mean.rotation.z = std::sin(0.5);
+    mean.rotation.w = std::cos(0.5);
+    geometry_msgs::Vector3 sigma;
+    sigma.x = 0.1; sigma.y = 0.2; sigma.z = 0.0;
+    std::vector<geometry_msgs::Transform> ts(100000);
+    random::normal_fill(ts, mean, sigma, 0.0, 0.0, 0.05);
+    Eigen::Vector3d tm = Eigen::Vector3d::Zero();
+    Eigen::Vector3d tv = Eigen::Vector3d::Zero();
+    Eigen::Quaterniond qm(mean.rotation.w, mean.rotation.x, mean.rotation.y, mean.rotation.z);
+    double yaw_var = 0.0;
+    for(const auto& t : ts)
+    {
+        Eigen::Vector3d v(t.translation.x, t.translation.y, t.translation.z);
+        tm += v;
+        tv += (v - Eigen::Vector3d(1.0, 2.0, 0.0)).cwiseAbs2();
+        // relative rotation in the frame of the mean, about z only
+        Eigen::Quaterniond dq = qm.inverse() * Eigen::Quaterniond(t.rotation.w, t.rotation.x, t.rotation.y, t.rotation.z);
+        if(std::fabs(dq.x()) > 1e-12 || std::fabs(dq.y()) > 1e-12)
+        {
+            ROS_WARN_STREAM("error: gaussian rotation axis");
+            ret = false;
+            break;
+        }
+        yaw_var += std::pow(2.0 * std::atan2(dq.z(), dq.w()), 2);
+    }
+    tm /= ts.size();
+    tv /= ts.size();
+    yaw_var /= ts.size();
+    // small angles: yaw ~ 2 * 0.05 * n
+    if((tm - Eigen::Vector3d(1.0, 2.0, 0.0)).norm() > 0.005 
+        || std::fabs(std::sqrt(tv.x()) - 0.1) > 0.002 || std::fabs(std::sqrt(tv.y()) - 0.2) > 0.004 
+        || tv.z() != 0.0 || std::fabs(std::sqrt(yaw_var) - 0.1) > 0.005)
+    {
+        ROS_WARN_STREAM("error: gaussian poses " << tm.transpose() << " " << tv.transpose() << " " << yaw_var);
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testSensors()
+{
+    bool ret = true;
+
+    // noise-free scan from the center of a 10 x 6 room
+    random::LaserScanParams lp;
+    lp.beams = 361;
+    lp.range_sigma = 0.0;
+    lp.dropout = 0.0;
+    lp.intensity_sigma = 0.0;
+    random::Philox gen(3, 0);
+    sensor_msgs::LaserScan scan = random::laser_scan(gen, lp);
+    // beams at -pi, -pi/2, 0, pi/2
+    if(scan.ranges.size() != 361 || scan.intensities.size() != 361
+        || std::fabs(scan.ranges[0] - 5.0) > 1e-5 || std::fabs(scan.ranges[90] - 3.0) > 1e-5
+        || std::fabs(scan.ranges[180] - 5.0) > 1e-5 || std::fabs(scan.ranges[270] - 3.0) > 1e-5)
+    {
+        ROS_WARN_STREAM("error: laser scan ranges");
+        ret = false;
+    }
+
+    // dropouts and the same offset reproduces the scan
+    lp.dropout = 0.5;
+    lp.range_sigma = 0.01;
+    random::laser_scan_fill(gen, scan, lp, 3000);
+    sensor_msgs::LaserScan scan2 = random::laser_scan(gen, lp, 3000);
+    const size_t dropped = std::count_if(scan.ranges.begin(), scan.ranges.end(), 
+        [](float r) { return std::isinf(r); });
+    if(scan.ranges != scan2.ranges || dropped < 130 || dropped > 230)
+    {
+        ROS_WARN_STREAM("error: laser scan dropouts " << dropped);
+        ret = false;
+    }
+
+    // noise-free spheres with outward normals
+    random::PointCloudParams cp;
+    cp.points = 1000;
+    cp.surface = random::Surface::SPHERE;
+    cp.size = 2.0;
+    cp.sigma = 0.0;
+    cp.pose.position.x = 1.0;
+    sensor_msgs::PointCloud pcl = random::point_cloud(cp);
+    std::vector<geometry_msgs::Vector3> normals = getNormals(pcl);
+    for(size_t i=0; i<pcl.points.size(); i++)
+    {
+        Eigen::Vector3d p(pcl.points[i].x - 1.0, pcl.points[i].y, pcl.points[i].z);
+        Eigen::Vector3d n(normals[i].x, normals[i].y, normals[i].z);
+        if(std::fabs(p.norm() - 1.0) > 1e-5 || (n - p).norm() > 1e-5)
+        {
+            ROS_WARN_STREAM("error: sphere point cloud");
+            ret = false;
+            break;
+        }
+    }
+
+    // box faces rotated with the pose
+    cp.surface = random::Surface::BOX;
+    cp.pose.orientation.z = std::sin(M_PI / 8);
+    cp.pose.orientation.w = std::cos(M_PI / 8);
+    random::point_cloud_fill(pcl, cp);
+    normals = getNormals(pcl);
+    for(size_t i=0; i<pcl.points.size(); i++)
+    {
+        Eigen::Vector3d p(pcl.points[i].x - 1.0, pcl.points[i].y, pcl.points[i].z);
+        Eigen::Vector3d n(normals[i].x, normals[i].y, normals[i].z);
+        if(std::fabs(p.dot(n) - 1.0) > 1e-5 || std::fabs(n.norm() - 1.0) > 1e-5)
+        {
+            ROS_WARN_STREAM("error: box point cloud");
+            ret = false;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+bool testLowDiscrepancy()
+{
+    bool ret = true;
+
+    // known answers (unscrambled Joe-Kuo Sobol, dyadic so exact)
+    const std::vector<double> sobol_77 = {0.8359375, 0.8359375, 0.0078125, 0.7734375, 0.8359375, 
+        0.5078125, 0.2265625, 0.6484375, 0.1796875, 0.4296875, 0.1328125, 0.7890625, 0.4921875, 
+        0.3359375, 0.9921875, 0.0703125, 0.8203125, 0.8828125, 0.7890625, 0.0078125, 0.1484375};
+    random::Sobol sobol(21);
+    for(size_t d=0; d<21; d++)
+    {
+        if(sobol.value(77, d) != sobol_77[d])
+        {
+            ROS_WARN_STREAM("error: sobol known answer in dimension " << d);
+            ret = false;
+            break;
+        }
+    }
+
+    // skip-ahead: chunks, parallel fills and value() agree
+    random::Sobol sobol_s(5, true, 11);
+    Eigen::MatrixXd full(5, 10000), chunk(5, 1500);
+    random::uniform_fill(sobol_s, full, 0.0, 1.0);
+    random::uniform_fill(sobol_s, chunk, 0.0, 1.0, 4321);
+    if(full.block(0, 4321, 5, 1500) != chunk || full(3, 9999) != sobol_s.value(9999, 3))
+    {
+        ROS_WARN_STREAM("error: sobol skip-ahead");
+        ret = false;
+    }
+
+    // radical inverses: 5 = 101 (base 2) = 12 (base 3)
+    random::Halton halton(3);
+    if(std::fabs(halton.value(5, 0) - 0.625) > 1e-15 || std::fabs(halton.value(5, 1) - 7.0 / 9.0) > 1e-15)
+    {
+        ROS_WARN_STREAM("error: halton known answer");
+        ret = false;
+    }
+
+    random::Halton halton_s(3, true, 5);
+    geometry_msgs::Point pmin, pmax;
+    pmax.x = 2.0; pmax.y = 1.0; pmax.z = 1.0;
+    std::vector<geometry_msgs::Point> hp_full = random::uniform_points(halton_s, pmin, pmax, 8000);
+    std::vector<geometry_msgs::Point> hp_chunk = random::uniform_points(halton_s, pmin, pmax, 100, 7000);
+    if(hp_chunk[42].x != hp_full[7042].x || hp_chunk[42].z != hp_full[7042].z)
+    {
+        ROS_WARN_STREAM("error: halton skip-ahead");
+        ret = false;
+    }
+
+    // integration of x * y * z over [0,2]x[0,1]x[0,1] (= 0.5) converges faster than random points
+    auto integrate = [](const std::vector<geometry_msgs::Point>& points) {
+        double sum = 0.0;
+        for(const auto& p : points)
+        {
+            sum += p.x * p.y * p.z;
+        }
+        return 2.0 * sum / points.size();
+    };
+    std::vector<geometry_msgs::Point> sp = random::uniform_points(random::Sobol(3, true, 3), pmin, pmax, 4096);
+    const double err_sobol = std::fabs(integrate(sp) - 0.5);
+    const double err_halton = std::fabs(integrate(hp_full) - 0.5);
+    if(err_sobol > 1e-3 || err_halton > 1e-3)
+    {
+        ROS_WARN_STREAM("error: quasi monte carlo integration " << err_sobol << " " << err_halton);
+        ret = false;
+    }
+
+    // orientations
+    std::vector<geometry_msgs::Quaternion> qs(1000);
+    random::uniform_fill(random::Sobol(3), qs);
+    for(const auto& q : qs)
+    {
+        if(std::fabs(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w - 1.0) > 1e-12)
+        {
+            ROS_WARN_STREAM("error: quasi random quaternion");
+            ret = false;
+            break;
+        }
+    }
+
+    // too few dimensions
+    try {
+        random::uniform_fill(random::Halton(2), qs);
+        ROS_WARN_STREAM("error: missing dimension check");
+        ret = false;
+    } catch(const std::runtime_error& ex) {
+
+    }
+
+    return ret;
+}
+
+bool testResampling()
+{
+    bool ret = true;
+
+    random::Engine gen(17);
+    const std::vector<double> weights = {0.0, 1.0, 2.0, 3.0, 4.0, 0.0};
+    const size_t N = 100000;
+
+    const std::vector<random::Resampling> methods = {
+        random::Resampling::MULTINOMIAL, random::Resampling::STRATIFIED, 
+        random::Resampling::SYSTEMATIC, random::Resampling::RESIDUAL};
+
+    for(const random::Resampling method : methods)
+    {
+        random::Resampler resampler(method);
+        std::vector<size_t> indices;
+        resampler.resample(gen, weights, N, indices);
+
+        std::vector<size_t> counts(weights.size(), 0);
+        for(const size_t i : indices)
+        {
+            counts[i]++;
+        }
+
+        for(size_t i=0; i<weights.size(); i++)
+        {
+            const double expected = N * weights[i] / 10.0;
+            // systematic and residual copies are within one of the expectation
+            const double tolerance = (method == random::Resampling::SYSTEMATIC) ? 1.0 
+                : (method == random::Resampling::MULTINOMIAL) ? 5.0 * std::sqrt(expected + 1.0) 
+                : 3.0 * std::sqrt(expected + 1.0);
+            if(indices.size() != N || std::fabs(counts[i] - expected) > tolerance 
+                || (weights[i] == 0.0 && counts[i] > 0)
+                || (method == random::Resampling::RESIDUAL && counts[i] < std::floor(expected)))
+            {
+                ROS_WARN_STREAM("error: resampling method " << static_cast<int>(method) 
+                    << " particle " << i << ": " << counts[i] << " copies, expected " << expected);
+                ret = false;
+            }
+        }
+    }
+
+    // particles in place, buffers are reused
+    geometry_msgs::PoseArray particles;
+    particles.poses.resize(1000);
+    for(size_t i=0; i<particles.poses.size(); i++)
+    {
+        particles.poses[i].position.x = i;
+    }
+    std::vector<double> w(1000, 0.0);
+    w[123] = 1.0;
+    random::Resampler resampler;
+    resampler.resample(gen, w, particles);
+    const geometry_msgs::Pose* buffer = particles.poses.data();
+    resampler.resample(gen, w, particles);
+    resampler.resample(gen, w, particles);
+    if(particles.poses.size() != 1000 || particles.poses[999].position.x != 123.0 
+        || particles.poses.data() != buffer)
+    {
+        ROS_WARN_STREAM("error: particle resampling");
+        ret = false;
+    }
+
+    if(std::fabs(random::effective_sample_size(weights) - 100.0 / 30.0) > 1e-12)
+    {
+        ROS_WARN_STREAM("error: effective sample size");
+        ret = false;
+    }
+
+    try {
+        random::resample({1.0, -1.0}, 2);
+        ROS_WARN_STREAM("error: negative weights accepted");
+        ret = false;
+    } catch(const std::runtime_error& ex) {
+
+    }
+
+    return ret;
+}
+
+bool testSubsampling()
+{
+    bool ret = true;
+
+    // index channel to check the alignment of points and channels
+    sensor_msgs::PointCloud cloud;
+    cloud.channels.resize(1);
+    cloud.channels[0].name = "index";
+    const size_t N = 200000;
+    for(size_t i=0; i<N; i++)
+    {
+        geometry_msgs::Point32 p;
+        p.x = (i % 100) * 0.1 + 0.05;
+        p.y = ((i / 100) % 10) * 0.1 + 0.05;
+        p.z = 0.0;
+        cloud.points.push_back(p);
+        cloud.channels[0].values.push_back(i);
+    }
+
+    const auto aligned = [&cloud](const sensor_msgs::PointCloud& c) {
+        for(size_t k=0; k<c.points.size(); k++)
+        {
+            if(c.channels.size() != 1 
+                || c.points[k].x != cloud.points[static_cast<size_t>(c.channels[0].values[k])].x
+                || c.points[k].y != cloud.points[static_cast<size_t>(c.channels[0].values[k])].y)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // parallel over chunks, independent of the number of threads
+    random::Engine gen(5);
+    const sensor_msgs::PointCloud sample = random::reservoir_sample(gen, cloud, 1000);
+    gen.seed(5);
+    const sensor_msgs::PointCloud sample2 = random::reservoir_sample(gen, cloud, 1000);
+    std::vector<float> ids = sample.channels[0].values;
+    std::sort(ids.begin(), ids.end());
+    const double mean = std::accumulate(ids.begin(), ids.end(), 0.0) / ids.size();
+    if(sample.points.size() != 1000 || !aligned(sample) 
+        || std::unique(ids.begin(), ids.end()) != ids.end()
+        || std::fabs(mean - N / 2.0) > 5.0 * N / std::sqrt(12.0 * 1000)
+        || sample2.channels[0].values != sample.channels[0].values)
+    {
+        ROS_WARN_STREAM("error: reservoir sample of " << sample.points.size() << " points, mean index " << mean);
+        ret = false;
+    }
+
+    // inclusion probabilities of streamed and merged reservoirs
+    sensor_msgs::PointCloud small = cloud;
+    small.points.resize(10);
+    small.channels[0].values.resize(10);
+    std::vector<size_t> counts(10, 0);
+    const size_t T = 20000;
+    for(size_t t=0; t<T; t++)
+    {
+        random::ReservoirSampler a(3, 2 * t), b(3, 2 * t + 1);
+        for(size_t i=0; i<6; i+=2)
+        {
+            a.add(small, i, i + 2);
+        }
+        b.add(small, 6, 10);
+        a.merge(b);
+        for(const float id : a.cloud().channels[0].values)
+        {
+            counts[static_cast<size_t>(id)]++;
+        }
+        if(a.seen() != 10 || a.size() != 3 || !aligned(a.cloud()))
+        {
+            ROS_WARN_STREAM("error: reservoir of " << a.size() << " points");
+            ret = false;
+            break;
+        }
+    }
+    for(size_t i=0; i<counts.size(); i++)
+    {
+        if(std::fabs(counts[i] - 0.3 * T) > 5.0 * std::sqrt(0.21 * T))
+        {
+            ROS_WARN_STREAM("error: point " << i << " sampled " << counts[i] << " times, expected " << 0.3 * T);
+            ret = false;
+        }
+    }
+
+    // one point per cell of the 100 x 10 grid
+    const sensor_msgs::PointCloud strata = random::stratified_sample(gen, cloud, 0.1);
+    std::vector<size_t> cells;
+    for(const geometry_msgs::Point32& p : strata.points)
+    {
+        cells.push_back(static_cast<size_t>(p.x * 10.0) + 100 * static_cast<size_t>(p.y * 10.0));
+    }
+    std::sort(cells.begin(), cells.end());
+    if(strata.points.size() != 1000 || !aligned(strata) 
+        || std::unique(cells.begin(), cells.end()) != cells.end())
+    {
+        ROS_WARN_STREAM("error: stratified sample of " << strata.points.size() << " points");
+        ret = false;
+    }
+
+    // uniform choice within a cell over merged samplers
+    sensor_msgs::PointCloud cell = small;
+    for(geometry_msgs::Point32& p : cell.points)
+    {
+        p.x = p.y = 0.5;
+    }
+    std::fill(counts.begin(), counts.end(), 0);
+    for(size_t t=0; t<T; t++)
+    {
+        random::StratifiedSampler a(1.0, 2 * t), b(1.0, 2 * t + 1);
+        a.add(cell, 0, 3);
+        b.add(cell, 3, 10);
+        a.merge(b);
+        counts[static_cast<size_t>(a.cloud().channels[0].values[0])]++;
+    }
+    for(size_t i=0; i<counts.size(); i++)
+    {
+        if(std::fabs(counts[i] - 0.1 * T) > 5.0 * std::sqrt(0.09 * T))
+        {
+            ROS_WARN_STREAM("error: point " << i << " chosen " << counts[i] << " times, expected " << 0.1 * T);
+            ret = false;
+        }
+    }
+
+    return ret;
+}
+
+std::string result(bool res)
+{
+    if(res)
+    {
+        return "success";
+    } else {
+        return "failure";
+    }
+}
+
+void test( std::string name, bool (*f)(void) )
+{
+    std::cout << "-- " << name << ": " << result(f()) << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "rosmath_random_test_node");
+
+    std::cout << "Tests of rosmath library: Random" << std::endl;
+
+    test("Engines", testEngines);
+    test("Philox", testPhilox);
+    test("Bulk", testBulk);
+    test("Poses", testPoses);
+    test("Sensors", testSensors);
+    test("Low Discrepancy", testLowDiscrepancy);
+    test("Resampling", testResampling);
+    test("Subsampling", testSubsampling);
+
+    return 0;
+}
@@ -1,8 +1,13 @@
 #include "Eigen/Dense"
 
 #include "rosmath/eigen/conversions.h"
+#include "rosmath/eigen/map.h"
 #include "rosmath/conversions.h"
 
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
 namespace rosmath {
 
 // POINTS
@@ -298,6 +303,158 @@ void convert(   const std::vector<double>& from,
     }
 }
 
+// CONTAINERS
+
+namespace {
+
+// packed doubles x, y, z, qx, qy, qz, qw
+static_assert(std::is_standard_layout<geometry_msgs::Pose>::value
+    && sizeof(geometry_msgs::Pose) == 7 * sizeof(double)
+    && offsetof(geometry_msgs::Pose, orientation) == 3 * sizeof(double),
+    "geometry_msgs::Pose is not seven packed doubles");
+
+void convert_pose( const geometry_msgs::Pose& from,
+                    Eigen::Isometry3d& to)
+{
+    const Eigen::Quaterniond q(from.orientation.w, from.orientation.x, 
+        from.orientation.y, from.orientation.z);
+    to.linear() = q.toRotationMatrix();
+    to.translation() << from.position.x, from.position.y, from.position.z;
+    to.makeAffine();
+}
+
+} // namespace
+
+void convert(   const std::vector<geometry_msgs::Point>& from,
+                Eigen::Matrix3Xd& to)
+{
+    to = eigen_map(from).transpose();
+}
+
+void convert(   const std::vector<geometry_msgs::Point>& from,
+                Eigen::Matrix3Xf& to)
+{
+    to = eigen_map(from).transpose().cast<float>();
+}
+
+void convert(   const Eigen::Matrix3Xd& from,
+                std::vector<geometry_msgs::Point>& to)
+{
+    to.resize(from.cols());
+    eigen_map(to) = from.transpose();
+}
+
+void convert(   const Eigen::Matrix3Xf& from,
+                std::vector<geometry_msgs::Point>& to)
+{
+    to.resize(from.cols());
+    eigen_map(to) = from.transpose().cast<double>();
+}
+
+void convert(   const std::vector<geometry_msgs::Point32>& from,
+                Eigen::Matrix3Xf& to)
+{
+    to = eigen_map(from).transpose();
+}
+
+void convert(   const std::vector<geometry_msgs::Point32>& from,
+                Eigen::Matrix3Xd& to)
+{
+    to = eigen_map(from).transpose().cast<double>();
+}
+
+void convert(   const Eigen::Matrix3Xf& from,
+                std::vector<geometry_msgs::Point32>& to)
+{
+    to.resize(from.cols());
+    eigen_map(to) = from.transpose();
+}
+
+void convert(   const Eigen::Matrix3Xd& from,
+                std::vector<geometry_msgs::Point32>& to)
+{
+    to.resize(from.cols());
+    eigen_map(to) = from.transpose().cast<float>();
+}
+
+void convert(   const std::vector<geometry_msgs::Pose>& from,
+                Isometry3dVector& to)
+{
+    to.resize(from.size());
+    for(size_t i=0; i<from.size(); i++)
+    {
+        convert_pose(from[i], to[i]);
+    }
+}
+
+void convert(   const Isometry3dVector& from,
+                std::vector<geometry_msgs::Pose>& to)
+{
+    to.resize(from.size());
+    for(size_t i=0; i<from.size(); i++)
+    {
+        const Eigen::Quaterniond q(from[i].linear());
+        const Eigen::Vector3d t = from[i].translation();
+        to[i].position.x = t.x();
+        to[i].position.y = t.y();
+        to[i].position.z = t.z();
+        to[i].orientation.x = q.x();
+        to[i].orientation.y = q.y();
+        to[i].orientation.z = q.z();
+        to[i].orientation.w = q.w();
+    }
+}
+
+void convert(   const std::vector<geometry_msgs::Pose>& from,
+                Matrix7Xd& to)
+{
+    to.resize(7, from.size());
+    if(!from.empty())
+    {
+        std::memcpy(to.data(), from.data(), from.size() * sizeof(geometry_msgs::Pose));
+    }
+}
+
+void convert(   const Matrix7Xd& from,
+                std::vector<geometry_msgs::Pose>& to)
+{
+    to.resize(from.cols());
+    if(!to.empty())
+    {
+        std::memcpy(static_cast<void*>(to.data()), from.data(), to.size() * sizeof(geometry_msgs::Pose));
+    }
+}
+
+void convert(   const nav_msgs::Path& from,
+                Isometry3dVector& to)
+{
+    to.resize(from.poses.size());
+    for(size_t i=0; i<from.poses.size(); i++)
+    {
+        convert_pose(from.poses[i].pose, to[i]);
+    }
+}
+
+void convert(   const nav_msgs::Path& from,
+                Matrix7Xd& to)
+{
+    to.resize(7, from.poses.size());
+    for(size_t i=0; i<from.poses.size(); i++)
+    {
+        std::memcpy(to.col(i).data(), &from.poses[i].pose, sizeof(geometry_msgs::Pose));
+    }
+}
+
+void convert(   const Matrix7Xd& from,
+                nav_msgs::Path& to)
+{
+    to.poses.resize(from.cols());
+    for(size_t i=0; i<to.poses.size(); i++)
+    {
+        std::memcpy(static_cast<void*>(&to.poses[i].pose), from.col(i).data(), sizeof(geometry_msgs::Pose));
+    }
+}
+
 // OPERATORS
 
 // POINTS
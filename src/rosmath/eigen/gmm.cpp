@@ -0,0 +1,324 @@
+#include "rosmath/eigen/gmm.h"
+#include "rosmath/random.h"
+#include <limits>
+#include <numeric>
+
+namespace rosmath {
+
+namespace stats {
+
+namespace {
+
+/**
+ * log(sum(exp(row))) for each row, in parallel over rows
+ */
+Eigen::VectorXd log_sum_exp(const Eigen::MatrixXd& L, bool parallel)
+{
+    Eigen::VectorXd ret(L.rows());
+
+    #pragma omp parallel for if(parallel)
+    for(Eigen::Index i=0; i<L.rows(); i++)
+    {
+        const double lmax = L.row(i).maxCoeff();
+        if(!std::isfinite(lmax))
+        {
+            ret(i) = lmax;
+            continue;
+        }
+        ret(i) = lmax + std::log((L.row(i).array() - lmax).exp().sum());
+    }
+
+    return ret;
+}
+
+/**
+ * k-means++ seeding: first center uniformly, then proportional to 
+ * the squared distance to the closest chosen center
+ */
+std::vector<Eigen::Index> kmeanspp(const Eigen::MatrixXd& X, size_t K)
+{
+    const Eigen::Index N = X.cols();
+    std::vector<Eigen::Index> centers;
+    centers.push_back(random::uniform_number(size_t(0), size_t(N - 1)));
+
+    Eigen::VectorXd d2 = (X.colwise() - X.col(centers[0])).colwise().squaredNorm().transpose();
+
+    while(centers.size() < K)
+    {
+        const double total = d2.sum();
+        Eigen::Index next = 0;
+        if(total > 0.0)
+        {
+            double r = random::uniform_number(0.0, total);
+            while(next < N - 1 && r >= d2(next))
+            {
+                r -= d2(next);
+                next++;
+            }
+        } else {
+            next = random::uniform_number(size_t(0), size_t(N - 1));
+        }
+        centers.push_back(next);
+
+        d2 = d2.cwiseMin((X.colwise() - X.col(next)).colwise().squaredNorm().transpose());
+    }
+
+    return centers;
+}
+
+} // namespace
+
+GaussianMixture::GaussianMixture()
+{
+
+}
+
+GaussianMixture::GaussianMixture(
+    const std::vector<double>& weights,
+    const std::vector<Normal>& components)
+:m_weights(weights)
+,m_components(components)
+{
+    if(m_weights.size() != m_components.size())
+    {
+        throw std::runtime_error("GaussianMixture: number of weights and components differ");
+    }
+}
+
+size_t GaussianMixture::size() const
+{
+    return m_components.size();
+}
+
+size_t GaussianMixture::dim() const
+{
+    return m_components.empty() ? 0 : m_components[0].dim();
+}
+
+const std::vector<double>& GaussianMixture::weights() const
+{
+    return m_weights;
+}
+
+const std::vector<Normal>& GaussianMixture::components() const
+{
+    return m_components;
+}
+
+Eigen::MatrixXd GaussianMixture::weightedLogLikelihoods(
+    const Eigen::MatrixXd& X, bool parallel) const
+{
+    Eigen::MatrixXd L(X.cols(), m_components.size());
+    for(size_t k=0; k<m_components.size(); k++)
+    {
+        L.col(k) = m_components[k].logpdf(X, parallel).array() + std::log(m_weights[k]);
+    }
+    return L;
+}
+
+double GaussianMixture::logpdf(const Eigen::VectorXd& X) const
+{
+    return logpdf(Eigen::MatrixXd(X))(0);
+}
+
+double GaussianMixture::pdf(const Eigen::VectorXd& X) const
+{
+    return std::exp(logpdf(X));
+}
+
+Eigen::VectorXd GaussianMixture::logpdf(const Eigen::MatrixXd& X, bool parallel) const
+{
+    return log_sum_exp(weightedLogLikelihoods(X, parallel), parallel);
+}
+
+Eigen::VectorXd GaussianMixture::pdf(const Eigen::MatrixXd& X, bool parallel) const
+{
+    return logpdf(X, parallel).array().exp();
+}
+
+Eigen::MatrixXd GaussianMixture::responsibilities(const Eigen::MatrixXd& X, bool parallel) const
+{
+    Eigen::MatrixXd L = weightedLogLikelihoods(X, parallel);
+    const Eigen::VectorXd lse = log_sum_exp(L, parallel);
+    
+    #pragma omp parallel for if(parallel)
+    for(Eigen::Index i=0; i<L.rows(); i++)
+    {
+        L.row(i) = (L.row(i).array() - lse(i)).exp();
+    }
+
+    return L;
+}
+
+size_t GaussianMixture::predict(const Eigen::VectorXd& X) const
+{
+    return predict(Eigen::MatrixXd(X))[0];
+}
+
+std::vector<size_t> GaussianMixture::predict(const Eigen::MatrixXd& X, bool parallel) const
+{
+    const Eigen::MatrixXd L = weightedLogLikelihoods(X, parallel);
+    std::vector<size_t> ret(L.rows());
+
+    #pragma omp parallel for if(parallel)
+    for(Eigen::Index i=0; i<L.rows(); i++)
+    {
+        Eigen::Index k;
+        L.row(i).maxCoeff(&k);
+        ret[i] = k;
+    }
+
+    return ret;
+}
+
+Eigen::VectorXd GaussianMixture::sample() const
+{
+    std::discrete_distribution<size_t> choose(m_weights.begin(), m_weights.end());
+    return m_components[choose(random::engine())].sample();
+}
+
+Eigen::MatrixXd GaussianMixture::samples(size_t N) const
+{
+    // number of samples per component, then sample each component in bulk
+    std::discrete_distribution<size_t> choose(m_weights.begin(), m_weights.end());
+    random::Engine& gen = random::engine();
+    std::vector<size_t> counts(m_components.size(), 0);
+    for(size_t i=0; i<N; i++)
+    {
+        counts[choose(gen)]++;
+    }
+
+    Eigen::MatrixXd ret(dim(), N);
+    Eigen::Index col = 0;
+    for(size_t k=0; k<m_components.size(); k++)
+    {
+        if(counts[k] > 0)
+        {
+            ret.middleCols(col, counts[k]) = m_components[k].samples(counts[k]);
+            col += counts[k];
+        }
+    }
+
+    return ret;
+}
+
+GaussianMixture GaussianMixture::fit(
+    const Eigen::MatrixXd& sX, 
+    const size_t K,
+    const size_t max_iterations,
+    const double tolerance,
+    const double regularization)
+{
+    const Eigen::Index N = sX.cols();
+    const Eigen::Index dim = sX.rows();
+
+    if(K == 0 || N < static_cast<Eigen::Index>(K))
+    {
+        throw std::runtime_error("GaussianMixture: need at least K samples");
+    }
+
+    const Eigen::MatrixXd I = Eigen::MatrixXd::Identity(dim, dim);
+    const Normal global = Normal::fit(sX);
+    const Eigen::MatrixXd global_cov = global.cov() + regularization * I;
+
+    // initialization
+    std::vector<Normal> components;
+    for(const Eigen::Index c : kmeanspp(sX, K))
+    {
+        components.push_back(Normal(sX.col(c), global_cov));
+    }
+    GaussianMixture gmm(std::vector<double>(K, 1.0 / K), components);
+
+    double ll_prev = -std::numeric_limits<double>::infinity();
+
+    for(size_t it=0; it<max_iterations; it++)
+    {
+        // E-step: responsibilities in log space, parallel over samples
+        Eigen::MatrixXd R = gmm.weightedLogLikelihoods(sX, true);
+        const Eigen::VectorXd lse = log_sum_exp(R, true);
+        const double ll = lse.sum();
+
+        #pragma omp parallel for
+        for(Eigen::Index i=0; i<N; i++)
+        {
+            R.row(i) = (R.row(i).array() - lse(i)).exp();
+        }
+
+        // M-step
+        const Eigen::VectorXd Nk = R.colwise().sum().transpose();
+        const Eigen::MatrixXd means = (sX * R).array().rowwise() / Nk.transpose().array();
+
+        std::vector<Normal> updated;
+        std::vector<double> weights(K);
+        for(size_t k=0; k<K; k++)
+        {
+            if(Nk(k) < std::numeric_limits<double>::epsilon() * N)
+            {
+                // collapsed component: restart at a random sample
+                const size_t c = random::uniform_number(size_t(0), size_t(N - 1));
+                updated.push_back(Normal(sX.col(c), global_cov));
+                weights[k] = 1.0 / N;
+                continue;
+            }
+
+            const Eigen::MatrixXd centered = sX.colwise() - means.col(k);
+            const Eigen::MatrixXd cov = (centered * R.col(k).asDiagonal() * centered.transpose()) / Nk(k) 
+                + regularization * I;
+            updated.push_back(Normal(means.col(k), cov));
+            weights[k] = Nk(k) / N;
+        }
+
+        const double wsum = std::accumulate(weights.begin(), weights.end(), 0.0);
+        for(double& w : weights)
+        {
+            w /= wsum;
+        }
+        gmm = GaussianMixture(weights, updated);
+
+        if(std::fabs(ll - ll_prev) <= tolerance * std::fabs(ll))
+        {
+            break;
+        }
+        ll_prev = ll;
+    }
+
+    return gmm;
+}
+
+GaussianMixture GaussianMixture::fit(
+    const std::vector<geometry_msgs::Point>& points,
+    const size_t K,
+    const size_t max_iterations,
+    const double tolerance,
+    const double regularization)
+{
+    Eigen::MatrixXd sX(3, points.size());
+    for(size_t i=0; i<points.size(); i++)
+    {
+        sX(0, i) = points[i].x;
+        sX(1, i) = points[i].y;
+        sX(2, i) = points[i].z;
+    }
+    return fit(sX, K, max_iterations, tolerance, regularization);
+}
+
+GaussianMixture GaussianMixture::fit(
+    const sensor_msgs::PointCloud& pcl,
+    const size_t K,
+    const size_t max_iterations,
+    const double tolerance,
+    const double regularization)
+{
+    Eigen::MatrixXd sX(3, pcl.points.size());
+    for(size_t i=0; i<pcl.points.size(); i++)
+    {
+        sX(0, i) = pcl.points[i].x;
+        sX(1, i) = pcl.points[i].y;
+        sX(2, i) = pcl.points[i].z;
+    }
+    return fit(sX, K, max_iterations, tolerance, regularization);
+}
+
+} // namespace stats
+
+} // namespace rosmath
@@ -0,0 +1,320 @@
+#include "rosmath/eigen/ndt.h"
+#include "rosmath/eigen/conversions.h"
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace rosmath {
+
+namespace stats {
+
+namespace {
+
+// ratio of the smallest to the largest eigenvalue of a voxel covariance
+constexpr double MIN_EIGENVALUE_RATIO = 1e-3;
+
+Eigen::Matrix3Xd to_matrix(const sensor_msgs::PointCloud& cloud)
+{
+    Eigen::Matrix3Xd ret(3, cloud.points.size());
+    for(size_t i=0; i<cloud.points.size(); i++)
+    {
+        ret(0, i) = cloud.points[i].x;
+        ret(1, i) = cloud.points[i].y;
+        ret(2, i) = cloud.points[i].z;
+    }
+    return ret;
+}
+
+NDTMap::Vector6 to_vector(const Eigen::Affine3d& T)
+{
+    NDTMap::Vector6 x;
+    x << T.translation(), matrix_to_rpy(T.linear());
+    return x;
+}
+
+} // namespace
+
+void NDTMap::Cell::add(const Eigen::Vector3d& p)
+{
+    // Welford
+    count++;
+    const Eigen::Vector3d delta = p - mean;
+    mean += delta / static_cast<double>(count);
+    scatter += delta * (p - mean).transpose();
+}
+
+void NDTMap::Cell::merge(const Cell& other)
+{
+    // Chan et al.
+    if(other.count == 0)
+    {
+        return;
+    }
+    const double na = count;
+    const double nb = other.count;
+    const double n = na + nb;
+    const Eigen::Vector3d delta = other.mean - mean;
+    mean += delta * (nb / n);
+    scatter += other.scatter + delta * delta.transpose() * (na * nb / n);
+    count += other.count;
+}
+
+NDTMap::NDTMap(double resolution, size_t min_points)
+:m_resolution(resolution)
+,m_min_points(std::max<size_t>(min_points, 3))
+,m_valid(0)
+{
+    if(resolution <= 0.0)
+    {
+        throw std::runtime_error("NDTMap: resolution has to be positive");
+    }
+}
+
+double NDTMap::resolution() const
+{
+    return m_resolution;
+}
+
+size_t NDTMap::size() const
+{
+    return m_valid;
+}
+
+void NDTMap::clear()
+{
+    m_cells.clear();
+    m_valid = 0;
+}
+
+int64_t NDTMap::key(const Eigen::Vector3d& p) const
+{
+    // 21 bit per axis
+    const int64_t offset = 1 << 20;
+    const int64_t mask = (1 << 21) - 1;
+    const int64_t x = (static_cast<int64_t>(std::floor(p.x() / m_resolution)) + offset) & mask;
+    const int64_t y = (static_cast<int64_t>(std::floor(p.y() / m_resolution)) + offset) & mask;
+    const int64_t z = (static_cast<int64_t>(std::floor(p.z() / m_resolution)) + offset) & mask;
+    return (x << 42) | (y << 21) | z;
+}
+
+void NDTMap::finalize(Cell& cell) const
+{
+    if(cell.count < m_min_points)
+    {
+        return;
+    }
+
+    const Eigen::Matrix3d cov = cell.scatter / static_cast<double>(cell.count - 1);
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> es(cov);
+    Eigen::Vector3d ev = es.eigenvalues();
+    const double min_ev = std::max(ev(2) * MIN_EIGENVALUE_RATIO, 
+        std::numeric_limits<double>::epsilon());
+    ev = ev.cwiseMax(min_ev);
+
+    cell.normal = Normal3(cell.mean, 
+        es.eigenvectors() * ev.asDiagonal() * es.eigenvectors().transpose());
+    // factorize now: score is evaluated in parallel
+    cell.normal.prepare();
+    cell.valid = true;
+}
+
+void NDTMap::insert(const Eigen::Matrix3Xd& points)
+{
+    std::vector<Table> locals;
+
+    #pragma omp parallel
+    {
+        #ifdef _OPENMP
+        #pragma omp single
+        locals.resize(omp_get_num_threads());
+        const int tid = omp_get_thread_num();
+        #else
+        locals.resize(1);
+        const int tid = 0;
+        #endif
+
+        Table& local = locals[tid];
+
+        #pragma omp for
+        for(Eigen::Index i=0; i<points.cols(); i++)
+        {
+            const Eigen::Vector3d p = points.col(i);
+            local[key(p)].add(p);
+        }
+    }
+
+    // merge and refit only the touched voxels
+    std::vector<Cell*> touched;
+    for(const Table& local : locals)
+    {
+        for(const auto& elem : local)
+        {
+            Cell& cell = m_cells[elem.first];
+            if(!cell.dirty)
+            {
+                cell.dirty = true;
+                touched.push_back(&cell);
+                if(cell.valid)
+                {
+                    m_valid--;
+                    cell.valid = false;
+                }
+            }
+            cell.merge(elem.second);
+        }
+    }
+
+    for(Cell* cell : touched)
+    {
+        cell->dirty = false;
+        finalize(*cell);
+        if(cell->valid)
+        {
+            m_valid++;
+        }
+    }
+}
+
+void NDTMap::insert(const std::vector<geometry_msgs::Point>& points)
+{
+    Eigen::Matrix3Xd P(3, points.size());
+    for(size_t i=0; i<points.size(); i++)
+    {
+        P(0, i) = points[i].x;
+        P(1, i) = points[i].y;
+        P(2, i) = points[i].z;
+    }
+    insert(P);
+}
+
+void NDTMap::insert(const sensor_msgs::PointCloud& cloud)
+{
+    insert(to_matrix(cloud));
+}
+
+const Normal3* NDTMap::cell(const Eigen::Vector3d& p) const
+{
+    const auto it = m_cells.find(key(p));
+    if(it == m_cells.end() || !it->second.valid)
+    {
+        return nullptr;
+    }
+    return &it->second.normal;
+}
+
+std::vector<Normal3> NDTMap::cells() const
+{
+    std::vector<Normal3> ret;
+    ret.reserve(m_valid);
+    for(const auto& elem : m_cells)
+    {
+        if(elem.second.valid)
+        {
+            ret.push_back(elem.second.normal);
+        }
+    }
+    return ret;
+}
+
+double NDTMap::score(
+    const Eigen::Matrix3Xd& points, 
+    const Vector6& x,
+    Vector6* gradient) const
+{
+    const Eigen::Matrix3d Rx = Eigen::AngleAxisd(x(3), Eigen::Vector3d::UnitX()).toRotationMatrix();
+    const Eigen::Matrix3d Ry = Eigen::AngleAxisd(x(4), Eigen::Vector3d::UnitY()).toRotationMatrix();
+    const Eigen::Matrix3d Rz = Eigen::AngleAxisd(x(5), Eigen::Vector3d::UnitZ()).toRotationMatrix();
+    const Eigen::Matrix3d R = Rz * Ry * Rx;
+    const Eigen::Vector3d t = x.head<3>();
+
+    // derivatives of R w.r.t. roll, pitch, yaw. dR_a/da = skew(axis) * R_a
+    Eigen::Matrix3d Kx, Ky, Kz;
+    Kx << 0, 0, 0,  0, 0, -1,  0, 1, 0;
+    Ky << 0, 0, 1,  0, 0, 0,  -1, 0, 0;
+    Kz << 0, -1, 0,  1, 0, 0,  0, 0, 0;
+    const Eigen::Matrix3d dR_roll = Rz * Ry * Kx * Rx;
+    const Eigen::Matrix3d dR_pitch = Rz * Ky * Ry * Rx;
+    const Eigen::Matrix3d dR_yaw = Kz * R;
+
+    const bool with_gradient = (gradient != nullptr);
+    double total = 0.0;
+    Vector6 total_gradient = Vector6::Zero();
+
+    #pragma omp parallel
+    {
+        double local = 0.0;
+        Vector6 local_gradient = Vector6::Zero();
+        Eigen::Matrix<double, 3, 6> J;
+        J.leftCols<3>() = Eigen::Matrix3d::Identity();
+
+        #pragma omp for nowait
+        for(Eigen::Index i=0; i<points.cols(); i++)
+        {
+            const Eigen::Vector3d p = points.col(i);
+            const Eigen::Vector3d pt = R * p + t;
+            const Normal3* N = cell(pt);
+            if(N == nullptr)
+            {
+                continue;
+            }
+
+            const Eigen::Vector3d q = pt - N->mean();
+            const Eigen::Vector3d Aq = N->covInv() * q;
+            const double e = std::exp(-0.5 * q.dot(Aq));
+            local += e;
+
+            if(with_gradient)
+            {
+                J.col(3) = dR_roll * p;
+                J.col(4) = dR_pitch * p;
+                J.col(5) = dR_yaw * p;
+                local_gradient -= e * (J.transpose() * Aq);
+            }
+        }
+
+        #pragma omp critical
+        {
+            total += local;
+            total_gradient += local_gradient;
+        }
+    }
+
+    if(with_gradient)
+    {
+        *gradient = total_gradient;
+    }
+
+    return total;
+}
+
+double NDTMap::score(
+    const sensor_msgs::PointCloud& cloud, 
+    const Vector6& x,
+    Vector6* gradient) const
+{
+    return score(to_matrix(cloud), x, gradient);
+}
+
+double NDTMap::score(
+    const sensor_msgs::PointCloud& cloud, 
+    const geometry_msgs::Transform& T) const
+{
+    Eigen::Affine3d Te;
+    convert(T, Te);
+    return score(cloud, to_vector(Te));
+}
+
+double NDTMap::score(
+    const sensor_msgs::PointCloud& cloud, 
+    const geometry_msgs::Pose& T) const
+{
+    Eigen::Affine3d Te;
+    convert(T, Te);
+    return score(cloud, to_vector(Te));
+}
+
+} // namespace stats
+
+} // namespace rosmath
@@ -0,0 +1,318 @@
+#include "rosmath/eigen/ransac.h"
+#include "rosmath/stats.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace rosmath {
+
+namespace stats {
+
+namespace {
+
+// relative size of degenerate (collinear / coincident) samples
+constexpr double DEGENERATE_EPS = 1e-12;
+
+Eigen::Matrix3Xd to_matrix(const std::vector<geometry_msgs::Point>& points)
+{
+    Eigen::Matrix3Xd ret(3, points.size());
+    for(size_t i=0; i<points.size(); i++)
+    {
+        ret.col(i) << points[i].x, points[i].y, points[i].z;
+    }
+    return ret;
+}
+
+Eigen::Matrix3Xd to_matrix(const sensor_msgs::PointCloud& cloud)
+{
+    Eigen::Matrix3Xd ret(3, cloud.points.size());
+    for(size_t i=0; i<cloud.points.size(); i++)
+    {
+        ret.col(i) << cloud.points[i].x, cloud.points[i].y, cloud.points[i].z;
+    }
+    return ret;
+}
+
+std::vector<geometry_msgs::Point> select(
+    const Eigen::Matrix3Xd& points,
+    const std::vector<size_t>& ids)
+{
+    std::vector<geometry_msgs::Point> ret(ids.size());
+    for(size_t k=0; k<ids.size(); k++)
+    {
+        ret[k].x = points(0, ids[k]);
+        ret[k].y = points(1, ids[k]);
+        ret[k].z = points(2, ids[k]);
+    }
+    return ret;
+}
+
+Eigen::Vector3d to_vector(const geometry_msgs::Point& p)
+{
+    return Eigen::Vector3d(p.x, p.y, p.z);
+}
+
+} // namespace
+
+size_t ransac_iterations(
+    const double confidence,
+    const double inlier_ratio,
+    const size_t sample_size)
+{
+    const double p_good = std::pow(inlier_ratio, static_cast<double>(sample_size));
+    if(p_good >= 1.0)
+    {
+        return 1;
+    }
+    if(p_good <= 0.0)
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+    const double n = std::ceil(std::log(1.0 - confidence) / std::log1p(-p_good));
+    return (n < static_cast<double>(std::numeric_limits<size_t>::max()))
+        ? std::max<size_t>(static_cast<size_t>(n), 1)
+        : std::numeric_limits<size_t>::max();
+}
+
+// Plane
+
+PlaneSolver::PlaneSolver(const Eigen::Matrix3Xd& points)
+:m_points(points)
+{
+
+}
+
+PlaneSolver::PlaneSolver(const std::vector<geometry_msgs::Point>& points)
+:m_points(to_matrix(points))
+{
+
+}
+
+PlaneSolver::PlaneSolver(const sensor_msgs::PointCloud& cloud)
+:m_points(to_matrix(cloud))
+{
+
+}
+
+size_t PlaneSolver::size() const
+{
+    return m_points.cols();
+}
+
+bool PlaneSolver::fit(const std::array<size_t, SAMPLE_SIZE>& sample, Model& model) const
+{
+    const Eigen::Vector3d a = m_points.col(sample[0]);
+    const Eigen::Vector3d ab = m_points.col(sample[1]) - a;
+    const Eigen::Vector3d ac = m_points.col(sample[2]) - a;
+    const Eigen::Vector3d n = ab.cross(ac);
+    const double norm = n.norm();
+
+    if(norm <= DEGENERATE_EPS * ab.squaredNorm() || norm <= DEGENERATE_EPS * ac.squaredNorm() || norm == 0.0)
+    {
+        return false;
+    }
+
+    model = Model(n / norm, a);
+    return true;
+}
+
+double PlaneSolver::error(const Model& model, size_t i) const
+{
+    return std::fabs(model.signedDistance(m_points.col(i)));
+}
+
+bool PlaneSolver::refine(const std::vector<size_t>& inliers, Model& model) const
+{
+    if(inliers.size() < SAMPLE_SIZE)
+    {
+        return false;
+    }
+
+    const std::vector<geometry_msgs::Point> points = select(m_points, inliers);
+    const geometry_msgs::Point m = rosmath::mean(points);
+    const PCA pc = rosmath::pca(rosmath::covariance(points, m));
+
+    // keep the orientation of the normal
+    Eigen::Vector3d n = pc.eigenvectors.col(0);
+    if(n.dot(model.normal()) < 0.0)
+    {
+        n = -n;
+    }
+    model = Model(n, to_vector(m));
+    return true;
+}
+
+// Line
+
+LineSolver::LineSolver(const Eigen::Matrix3Xd& points)
+:m_points(points)
+{
+
+}
+
+LineSolver::LineSolver(const std::vector<geometry_msgs::Point>& points)
+:m_points(to_matrix(points))
+{
+
+}
+
+LineSolver::LineSolver(const sensor_msgs::PointCloud& cloud)
+:m_points(to_matrix(cloud))
+{
+
+}
+
+size_t LineSolver::size() const
+{
+    return m_points.cols();
+}
+
+bool LineSolver::fit(const std::array<size_t, SAMPLE_SIZE>& sample, Model& model) const
+{
+    const Eigen::Vector3d a = m_points.col(sample[0]);
+    const Eigen::Vector3d d = m_points.col(sample[1]) - a;
+    const double norm = d.norm();
+
+    if(norm <= DEGENERATE_EPS * a.norm() || norm == 0.0)
+    {
+        return false;
+    }
+
+    model = Model(a, d / norm);
+    return true;
+}
+
+double LineSolver::error(const Model& model, size_t i) const
+{
+    return model.distance(m_points.col(i));
+}
+
+bool LineSolver::refine(const std::vector<size_t>& inliers, Model& model) const
+{
+    if(inliers.size() < SAMPLE_SIZE)
+    {
+        return false;
+    }
+
+    const std::vector<geometry_msgs::Point> points = select(m_points, inliers);
+    const geometry_msgs::Point m = rosmath::mean(points);
+    const PCA pc = rosmath::pca(rosmath::covariance(points, m));
+
+    Eigen::Vector3d d = pc.eigenvectors.col(2);
+    if(d.dot(model.direction()) < 0.0)
+    {
+        d = -d;
+    }
+    model = Model(to_vector(m), d);
+    return true;
+}
+
+// Rigid
+
+RigidSolver::RigidSolver(const Eigen::Matrix3Xd& source, const Eigen::Matrix3Xd& target)
+:m_source(source)
+,m_target(target)
+{
+    if(m_source.cols() != m_target.cols())
+    {
+        throw std::runtime_error("RigidSolver: source and target have different sizes");
+    }
+}
+
+RigidSolver::RigidSolver(
+    const std::vector<geometry_msgs::Point>& source,
+    const std::vector<geometry_msgs::Point>& target)
+:RigidSolver(to_matrix(source), to_matrix(target))
+{
+
+}
+
+size_t RigidSolver::size() const
+{
+    return m_source.cols();
+}
+
+bool RigidSolver::fit(const std::array<size_t, SAMPLE_SIZE>& sample, Model& model) const
+{
+    Eigen::Matrix3d src, dst;
+    for(size_t k=0; k<SAMPLE_SIZE; k++)
+    {
+        src.col(k) = m_source.col(sample[k]);
+        dst.col(k) = m_target.col(sample[k]);
+    }
+
+    // collinear sources leave the rotation about their line undetermined
+    const Eigen::Vector3d ab = src.col(1) - src.col(0);
+    const Eigen::Vector3d ac = src.col(2) - src.col(0);
+    const double area = ab.cross(ac).norm();
+    if(area <= DEGENERATE_EPS * (ab.squaredNorm() + ac.squaredNorm()) || area == 0.0)
+    {
+        return false;
+    }
+
+    model.matrix() = Eigen::umeyama(src, dst, false);
+    return true;
+}
+
+double RigidSolver::error(const Model& model, size_t i) const
+{
+    return (model * m_source.col(i) - m_target.col(i)).norm();
+}
+
+bool RigidSolver::refine(const std::vector<size_t>& inliers, Model& model) const
+{
+    if(inliers.size() < SAMPLE_SIZE)
+    {
+        return false;
+    }
+
+    Eigen::Matrix3Xd src(3, inliers.size()), dst(3, inliers.size());
+    for(size_t k=0; k<inliers.size(); k++)
+    {
+        src.col(k) = m_source.col(inliers[k]);
+        dst.col(k) = m_target.col(inliers[k]);
+    }
+
+    model.matrix() = Eigen::umeyama(src, dst, false);
+    return true;
+}
+
+RansacResult<PlaneSolver::Model> ransac_plane(
+    const std::vector<geometry_msgs::Point>& points,
+    const RansacParams& params)
+{
+    return ransac(PlaneSolver(points), params);
+}
+
+RansacResult<PlaneSolver::Model> ransac_plane(
+    const sensor_msgs::PointCloud& cloud,
+    const RansacParams& params)
+{
+    return ransac(PlaneSolver(cloud), params);
+}
+
+RansacResult<LineSolver::Model> ransac_line(
+    const std::vector<geometry_msgs::Point>& points,
+    const RansacParams& params)
+{
+    return ransac(LineSolver(points), params);
+}
+
+RansacResult<LineSolver::Model> ransac_line(
+    const sensor_msgs::PointCloud& cloud,
+    const RansacParams& params)
+{
+    return ransac(LineSolver(cloud), params);
+}
+
+RansacResult<RigidSolver::Model> ransac_rigid(
+    const std::vector<geometry_msgs::Point>& source,
+    const std::vector<geometry_msgs::Point>& target,
+    const RansacParams& params)
+{
+    return ransac(RigidSolver(source, target), params);
+}
+
+} // namespace stats
+
+} // namespace rosmath
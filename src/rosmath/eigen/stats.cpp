@@ -1,6 +1,6 @@
 #include "rosmath/eigen/stats.h"
-#include <unsupported/Eigen/MatrixFunctions>
 #include "rosmath/stats.h"
+#include "rosmath/eigen/conversions.h"
 
 namespace rosmath {
 
@@ -14,210 +14,226 @@ double mahalanobis_dist(
     return (X - mean).transpose() * covInv * (X - mean);
 }
 
-Normal::Normal(const Eigen::VectorXd& mean, 
-            const Eigen::MatrixXd& cov)
-:m_mean(mean)
-,m_cov(cov)
+Eigen::Matrix3d rpy_to_matrix(const Eigen::Vector3d& rpy)
 {
-    m_cov_inv = m_cov.inverse();
-    m_det = m_cov.determinant();
-
-    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen_solver(cov);
-    Eigen::MatrixXd eigenvectors = eigen_solver.eigenvectors().real();
-
-    // Find the eigenvalues of the covariance matrix
-    Eigen::MatrixXd eigenvalues = eigen_solver.eigenvalues().real().asDiagonal();
-    
-    // Find the transformation matrix
-    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(eigenvalues);
-    Eigen::MatrixXd sqrt_eigenvalues = es.operatorSqrt();
-    m_transform = eigenvectors * sqrt_eigenvalues;
+    return (Eigen::AngleAxisd(rpy(2), Eigen::Vector3d::UnitZ())
+        * Eigen::AngleAxisd(rpy(1), Eigen::Vector3d::UnitY())
+        * Eigen::AngleAxisd(rpy(0), Eigen::Vector3d::UnitX())).toRotationMatrix();
 }
 
-Normal::~Normal()
+Eigen::Vector3d matrix_to_rpy(const Eigen::Matrix3d& R)
 {
-    
+    return Eigen::Vector3d(
+        std::atan2(R(2,1), R(2,2)),
+        std::asin(std::max(-1.0, std::min(1.0, -R(2,0)))),
+        std::atan2(R(1,0), R(0,0)));
 }
 
-double Normal::mahalanobisDist(const Eigen::VectorXd& X) const
+namespace {
+
+// maps roll, pitch, yaw rates to the angular velocity in the fixed frame
+Eigen::Matrix3d rpy_rates_to_omega(const Eigen::Vector3d& rpy)
 {
-    return mahalanobis_dist(m_mean, m_cov_inv, X);
+    const double cp = std::cos(rpy(1)), sp = std::sin(rpy(1));
+    const double cy = std::cos(rpy(2)), sy = std::sin(rpy(2));
+    Eigen::Matrix3d E;
+    E << cy * cp, -sy, 0.0,
+         sy * cp,  cy, 0.0,
+         -sp,     0.0, 1.0;
+    return E;
 }
 
-double Normal::pdf(const Eigen::VectorXd& X) const
+Eigen::Affine3d to_affine(const geometry_msgs::Transform& T)
 {
-    double dim = X.rows();
-    double invnorm = std::pow(SQRT2PI, dim) * std::sqrt(m_det);
-    return exp(-0.5 * mahalanobisDist(X)) / invnorm;
+    Eigen::Affine3d ret;
+    convert(T, ret);
+    return ret;
 }
 
-Eigen::VectorXd Normal::pdf(const Eigen::MatrixXd& X) const
+Eigen::Affine3d to_affine(const geometry_msgs::Pose& T)
 {
-    size_t dim = X.rows();
-    Eigen::VectorXd ret(X.cols());
-    for(size_t i=0; i<X.cols(); i++)
-    {
-        ret(i) = pdf(Eigen::VectorXd(X.block(0,i,dim,1)));
-    }
+    Eigen::Affine3d ret;
+    convert(T, ret);
     return ret;
 }
 
-Eigen::VectorXd Normal::sample() const
+template<typename NormalT>
+std::vector<NormalT> transform_all(
+    const Eigen::Affine3d& T, 
+    const std::vector<NormalT>& Ns, 
+    bool parallel)
 {
-    std::normal_distribution<double> dist(0.0, 1.0);
-    size_t dim = m_mean.rows();
-    Eigen::VectorXd x(dim);
-
-    for(size_t i=0; i<dim; i++)
+    // validate serially: exceptions must not escape the parallel region
+    for(const NormalT& N : Ns)
     {
-        x(i) = dist(random::engine);
+        if(N.dim() != 3 && N.dim() != 6)
+        {
+            throw std::runtime_error("transform: rigid transforms require a 3D point or 6D pose Normal, got dim " 
+                + std::to_string(N.dim()));
+        }
     }
 
-    return m_transform * x + m_mean;
-}
-
-Eigen::MatrixXd Normal::samples(size_t N) const
-{
-    std::normal_distribution<double> dist(0.0, 1.0);
-    size_t dim = m_mean.rows();
-    Eigen::MatrixXd samples(dim, N);
+    std::vector<NormalT> ret(Ns);
 
-    for(size_t i=0; i<dim; i++)
+    #pragma omp parallel for if(parallel)
+    for(size_t i=0; i<Ns.size(); i++)
     {
-        for(size_t j=0; j<N; j++)
-        {
-            samples(i,j) = dist(random::engine);
-        }
+        ret[i] = transform(T, Ns[i]);
     }
 
-    return m_transform * samples + m_mean.replicate(1, N);
+    return ret;
 }
 
-Eigen::VectorXd Normal::mean() const
+} // namespace
+
+Normal3 transform(const Eigen::Affine3d& T, const Normal3& N)
 {
-    return m_mean;
+    const Eigen::Matrix3d R = T.linear();
+    return Normal3(T * N.mean(), R * N.cov() * R.transpose());
 }
 
-Eigen::MatrixXd Normal::cov() const
+Normal3 transform(const geometry_msgs::Transform& T, const Normal3& N)
 {
-    return m_cov;
+    return transform(to_affine(T), N);
 }
 
-Eigen::MatrixXd Normal::covInv() const
+Normal3 transform(const geometry_msgs::Pose& T, const Normal3& N)
 {
-    return m_cov_inv;
+    return transform(to_affine(T), N);
 }
 
-double Normal::covDet() const
+Normal6 transform(const Eigen::Affine3d& T, const Normal6& N)
 {
-    return m_det;
+    const Eigen::Matrix3d R = T.linear();
+
+    Normal6::Vector mean;
+    mean.head<3>() = T * N.mean().head<3>();
+    mean.tail<3>() = matrix_to_rpy(R * rpy_to_matrix(N.mean().tail<3>()));
+
+    // d(rpy') = E(rpy')^-1 * R * E(rpy) * d(rpy)
+    Normal6::Matrix J = Normal6::Matrix::Zero();
+    J.block<3,3>(0,0) = R;
+    J.block<3,3>(3,3) = rpy_rates_to_omega(mean.tail<3>()).inverse() 
+        * R * rpy_rates_to_omega(N.mean().tail<3>());
+
+    return Normal6(mean, J * N.cov() * J.transpose());
 }
 
-size_t Normal::dim() const
+Normal6 transform(const geometry_msgs::Transform& T, const Normal6& N)
 {
-    return m_cov.rows();
+    return transform(to_affine(T), N);
 }
 
-Normal Normal::fit(const Eigen::MatrixXd& sX)
+Normal6 transform(const geometry_msgs::Pose& T, const Normal6& N)
 {
-    size_t dim = sX.rows();
-    Eigen::VectorXd mean = sX.rowwise().mean();
-    auto centered = sX.colwise() - mean;
-    auto cov = (centered * centered.adjoint()) / double(sX.cols() - 1);
-    return Normal(mean, cov);
+    return transform(to_affine(T), N);
 }
 
-Normal Normal::fit(
-        const Eigen::MatrixXd& sX, 
-        const Eigen::VectorXd& sY)
+Normal transform(const Eigen::Affine3d& T, const Normal& N)
 {
-    throw std::runtime_error("TODO: implement");
-    size_t dim = sX.rows();
-    Eigen::VectorXd mean = sX.rowwise().mean();
-    auto centered = sX.colwise() - mean;
-    auto cov = (centered * centered.adjoint()) / double(sX.cols() - 1);
-    return Normal(mean, cov);
+    if(N.dim() == 3)
+    {
+        const Normal3 res = transform(T, Normal3(N.mean(), N.cov()));
+        return Normal(res.mean(), res.cov());
+    } else if(N.dim() == 6) {
+        const Normal6 res = transform(T, Normal6(N.mean(), N.cov()));
+        return Normal(res.mean(), res.cov());
+    }
+
+    throw std::runtime_error("transform: rigid transforms require a 3D point or 6D pose Normal, got dim " 
+        + std::to_string(N.dim()));
 }
 
-Normal Normal::fuse(const Normal& N) const
+Normal transform(const geometry_msgs::Transform& T, const Normal& N)
 {
-    Eigen::MatrixXd JI = (N.cov() + m_cov).inverse();   
-    Eigen::MatrixXd cov = N.cov() * m_cov * JI;
-    Eigen::VectorXd mean = N.cov() * JI * m_mean + m_cov * JI * N.mean();
-    return Normal(mean, cov);
+    return transform(to_affine(T), N);
 }
 
-Normal Normal::transform(const Eigen::MatrixXd& T) const
+Normal transform(const geometry_msgs::Pose& T, const Normal& N)
 {
-    return Normal(T * m_mean, T * m_cov * T.transpose());
+    return transform(to_affine(T), N);
 }
 
-Normal Normal::add(const Normal& N) const
+std::vector<Normal3> transform(const geometry_msgs::Transform& T, const std::vector<Normal3>& Ns, bool parallel)
 {
-    return Normal(N.mean() + m_mean, N.cov() + m_cov);
+    return transform_all(to_affine(T), Ns, parallel);
 }
 
-Normal fuse(const std::vector<Normal>& Ns)
+std::vector<Normal3> transform(const geometry_msgs::Pose& T, const std::vector<Normal3>& Ns, bool parallel)
 {
-    Normal N = Ns[0];
-    
-    for(size_t i=1; i<Ns.size(); i++)
-    {
-        N = N.fuse(Ns[i]);
-    }
+    return transform_all(to_affine(T), Ns, parallel);
+}
 
-    return N;
+std::vector<Normal6> transform(const geometry_msgs::Transform& T, const std::vector<Normal6>& Ns, bool parallel)
+{
+    return transform_all(to_affine(T), Ns, parallel);
 }
 
-double kullback_leibler_divergence(const Normal& N0, const Normal& N1)
+std::vector<Normal6> transform(const geometry_msgs::Pose& T, const std::vector<Normal6>& Ns, bool parallel)
 {
-    double dim = N1.mean().rows();
-    return 0.5 * ( ( N1.covInv() * N0.cov() ).trace() + mahalanobis_dist(N0.mean(), N1.covInv(), N1.mean()) - dim + std::log(N1.covDet() / N0.covDet()) );
+    return transform_all(to_affine(T), Ns, parallel);
 }
 
-double fisher_information(const Normal& N1, const Normal& N2)
+std::vector<Normal> transform(const geometry_msgs::Transform& T, const std::vector<Normal>& Ns, bool parallel)
 {
-    return (N2.covInv() * (N1.mean() - N2.mean())).squaredNorm() + (N2.covInv() * N2.covInv() * N1.cov() - 2.0 * N2.covInv() + N1.covInv() ).trace();
+    return transform_all(to_affine(T), Ns, parallel);
 }
 
-double wasserstein(
-    const Normal& N1,
-    const Normal& N2)
+std::vector<Normal> transform(const geometry_msgs::Pose& T, const std::vector<Normal>& Ns, bool parallel)
 {
-    Eigen::MatrixXd cov2sqrt = N2.cov().sqrt();
-    return std::sqrt((N2.mean() - N1.mean()).squaredNorm() + 
-            (
-                N2.cov() + N1.cov() 
-                - 2 * (
-                    cov2sqrt * N1.cov() * cov2sqrt 
-                ).sqrt()
-            ).trace());
+    return transform_all(to_affine(T), Ns, parallel);
 }
 
-double hellinger(
-    const Normal& N1,
-    const Normal& N2)
+} // namespace stats
+
+// CONVERSIONS
+void convert(   const geometry_msgs::PoseWithCovariance& from,
+                stats::Normal6& to)
 {
-    double combDet1 = (N2.cov() * N1.cov()).determinant();
-    double combDet2 = ((N2.cov() + N1.cov())/2.0).determinant();
-    return std::sqrt(2.0 - 2.0 * std::sqrt(std::sqrt(combDet1)) / std::sqrt(combDet2) 
-       * std::exp(-1.0/4.0 * mahalanobis_dist(N2.mean(), (N2.cov() + N1.cov()).inverse(), N1.mean() ) ) );
+    Eigen::Quaterniond q;
+    convert(from.pose.orientation, q);
+
+    stats::Normal6::Vector mean;
+    mean << from.pose.position.x, from.pose.position.y, from.pose.position.z, 
+            stats::matrix_to_rpy(q.toRotationMatrix());
+
+    stats::Normal6::Matrix cov;
+    convert(from.covariance, cov);
+    to = stats::Normal6(mean, cov);
 }
 
-double entropy(
-    const Normal& N)
+void convert(   const stats::Normal6& from,
+                geometry_msgs::PoseWithCovariance& to)
 {
-    double dim = static_cast<double>(N.dim());
-    return 0.5 * std::log(N.covDet()) + 0.5 * dim * (1 + std::log(2 * M_PI) );
+    to.pose.position.x = from.mean()(0);
+    to.pose.position.y = from.mean()(1);
+    to.pose.position.z = from.mean()(2);
+    convert(Eigen::Quaterniond(stats::rpy_to_matrix(from.mean().tail<3>())), to.pose.orientation);
+    convert(from.cov(), to.covariance);
 }
 
-double cross_entropy(
-    const Normal& P, 
-    const Normal& Q)
+void convert(   const geometry_msgs::TwistWithCovariance& from,
+                stats::Normal6& to)
 {
-    return entropy(P) + kullback_leibler_divergence(P, Q);
+    stats::Normal6::Vector mean;
+    mean << from.twist.linear.x, from.twist.linear.y, from.twist.linear.z,
+            from.twist.angular.x, from.twist.angular.y, from.twist.angular.z;
+
+    stats::Normal6::Matrix cov;
+    convert(from.covariance, cov);
+    to = stats::Normal6(mean, cov);
 }
 
-} // namespace stats
+void convert(   const stats::Normal6& from,
+                geometry_msgs::TwistWithCovariance& to)
+{
+    to.twist.linear.x = from.mean()(0);
+    to.twist.linear.y = from.mean()(1);
+    to.twist.linear.z = from.mean()(2);
+    to.twist.angular.x = from.mean()(3);
+    to.twist.angular.y = from.mean()(4);
+    to.twist.angular.z = from.mean()(5);
+    convert(from.cov(), to.covariance);
+}
 
-} // namespace rosmath
\ No newline at end of file
+} // namespace rosmath
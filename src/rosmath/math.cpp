@@ -5,6 +5,7 @@
 #include "rosmath/math.h"
 #include "rosmath/conversions.h"
 #include "rosmath/eigen/conversions.h"
+#include "rosmath/eigen/map.h"
 #include "rosmath/exceptions.h"
 
 namespace rosmath {
@@ -534,8 +535,7 @@ boost::array<double, 36> multCov(const geometry_msgs::Transform& T,
     const boost::array<double, 36>& covariance)
 {
     boost::array<double, 36> ret;
-    Eigen::Matrix<double, 6, 6> cov;
-    convert(covariance, cov);
+    Eigen::Matrix<double, 6, 6> cov = eigen_map(covariance);
     Eigen::Matrix3d R;
     R <<= T.rotation;
     cov.block<3,3>(0,0) = R * cov.block<3,3>(0,0) * R.transpose();
@@ -545,7 +545,7 @@ boost::array<double, 36> multCov(const geometry_msgs::Transform& T,
     Eigen::Matrix3d tmp;
     tmp <<= q * qcov * q.inverse();
     cov.block<3,3>(3,3) = tmp;
-    convert(cov, ret);
+    eigen_map(ret) = cov;
     return ret;
 }
 
@@ -3,45 +3,46 @@
 #include "rosmath/opencv/conversions.h"
 #include "rosmath/math.h"
 #include "rosmath/misc.h"
+// layout checks of Point and Point32
+#include "rosmath/eigen/map.h"
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 namespace rosmath 
 {
 
 void convert(const Eigen::Matrix3d& from, cv::Mat& to)
 {
-    to = cv::Mat(3,3, CV_64F, double(0));
-    for(int i=0; i<3; i++)
-    {
-        for(int j=0; j<3; j++)
-        {
-            to.at<double>(i,j) = from(i,j);
-        }
-    }
+    // a new matrix: to may share its data or be a view of a larger matrix
+    to = cv::Mat(3, 3, CV_64F);
+    Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor> >(to.ptr<double>()) = from;
 }
 
 void convert(const cv::Mat& from, Eigen::Matrix3d& to)
 {
+    if(from.rows != 3 || from.cols != 3 || from.channels() != 1)
+    {
+        throw std::runtime_error("convert: expected 3 x 3 matrix, got "
+            + std::to_string(from.rows) + " x " + std::to_string(from.cols) 
+            + " with " + std::to_string(from.channels()) + " channels");
+    }
+
+    cv::Mat m;
     if(from.type() == CV_64F)
     {
-        for(int i=0; i<3; i++)
-        {
-            for(int j=0; j<3; j++)
-            {
-                to(i,j) = from.at<double>(i,j);
-            }
-        }
+        m = from;
     } else {
         // need to convert first
-        cv::Mat from_converted;
-        from.convertTo(from_converted, CV_64F);
-        for(int i=0; i<3; i++)
-        {
-            for(int j=0; j<3; j++)
-            {
-                to(i,j) = from_converted.at<double>(i,j);
-            }
-        }
+        from.convertTo(m, CV_64F);
     }
+
+    // row step of m, which may be a view of a larger matrix
+    to = Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>, 0, Eigen::OuterStride<> >(
+        m.ptr<double>(), Eigen::OuterStride<>(static_cast<Eigen::Index>(m.step1())));
 }
 
 void convert(
@@ -144,4 +145,217 @@ void convert(const cv::Mat& rvec, const cv::Mat& tvec,
     to = optical2ros(popt);
 }
 
+// POINT SETS
+
+namespace {
+
+static_assert(sizeof(cv::Point3f) == 3 * sizeof(float), 
+    "cv::Point3f is not three packed floats");
+
+static_assert(std::is_standard_layout<geometry_msgs::Point32>::value
+    && sizeof(geometry_msgs::Point32) == 3 * sizeof(float)
+    && offsetof(geometry_msgs::Point32, x) == 0,
+    "geometry_msgs::Point32 is not three packed floats");
+
+// N x 3 (one channel) or N x 1 / 1 x N (three channels)
+size_t point_count(const cv::Mat& m)
+{
+    if(m.empty())
+    {
+        return 0;
+    }
+    if(m.channels() == 1 && m.cols == 3)
+    {
+        return m.rows;
+    }
+    if(m.channels() == 3 && (m.cols == 1 || m.rows == 1))
+    {
+        return m.total();
+    }
+    throw std::runtime_error("convert: expected N x 3 matrix or N x 1 matrix with three channels, got "
+        + std::to_string(m.rows) + " x " + std::to_string(m.cols) 
+        + " with " + std::to_string(m.channels()) + " channels");
+}
+
+// copies the points of from to packed xyz values in to
+template<typename T>
+void copy_points(const cv::Mat& from, T* to)
+{
+    const size_t n = point_count(from);
+    if(n == 0)
+    {
+        return;
+    }
+
+    cv::Mat m = from;
+    if(m.depth() != cv::DataType<T>::depth)
+    {
+        from.convertTo(m, cv::DataType<T>::depth);
+    }
+
+    if(m.isContinuous())
+    {
+        std::memcpy(to, m.ptr<T>(), n * 3 * sizeof(T));
+    } else {
+        // row-wise for views (one point per row)
+        for(size_t i=0; i<n; i++)
+        {
+            std::memcpy(to + 3 * i, m.ptr<T>(i), 3 * sizeof(T));
+        }
+    }
+}
+
+// N x 3 matrix of depth from packed xyz values
+template<typename T>
+void create_points(const T* from, const size_t n, cv::Mat& to, const int depth)
+{
+    if(depth != CV_32F && depth != CV_64F)
+    {
+        throw std::runtime_error("convert: points have to be converted to CV_32F or CV_64F");
+    }
+
+    // a new matrix: to may share its data or be a view of a larger matrix
+    to = cv::Mat(static_cast<int>(n), 3, depth);
+
+    if(depth == cv::DataType<T>::depth)
+    {
+        if(n > 0)
+        {
+            std::memcpy(to.ptr<T>(), from, n * 3 * sizeof(T));
+        }
+    } else {
+        // a single conversion pass over a header on the points
+        cv::Mat(static_cast<int>(n), 3, cv::DataType<T>::depth, const_cast<T*>(from)).convertTo(to, depth);
+    }
+}
+
+} // namespace
+
+void convert(const std::vector<geometry_msgs::Point>& from, cv::Mat& to, 
+    const int depth)
+{
+    create_points(reinterpret_cast<const double*>(from.data()), from.size(), to, depth);
+}
+
+void convert(const std::vector<geometry_msgs::Point32>& from, cv::Mat& to, 
+    const int depth)
+{
+    create_points(reinterpret_cast<const float*>(from.data()), from.size(), to, depth);
+}
+
+void convert(const sensor_msgs::PointCloud& from, cv::Mat& to, 
+    const int depth)
+{
+    convert(from.points, to, depth);
+}
+
+void convert(const cv::Mat& from, std::vector<geometry_msgs::Point>& to)
+{
+    to.resize(point_count(from));
+    copy_points(from, reinterpret_cast<double*>(to.data()));
+}
+
+void convert(const cv::Mat& from, std::vector<geometry_msgs::Point32>& to)
+{
+    to.resize(point_count(from));
+    copy_points(from, reinterpret_cast<float*>(to.data()));
+}
+
+void convert(const cv::Mat& from, sensor_msgs::PointCloud& to)
+{
+    const size_t n = to.points.size();
+    convert(from, to.points);
+    if(to.points.size() != n)
+    {
+        to.channels.clear();
+    }
+}
+
+void convert(const std::vector<geometry_msgs::Point>& from, std::vector<cv::Point3f>& to)
+{
+    to.resize(from.size());
+    for(size_t i=0; i<from.size(); i++)
+    {
+        to[i].x = from[i].x;
+        to[i].y = from[i].y;
+        to[i].z = from[i].z;
+    }
+}
+
+void convert(const std::vector<geometry_msgs::Point32>& from, std::vector<cv::Point3f>& to)
+{
+    to.resize(from.size());
+    if(!from.empty())
+    {
+        std::memcpy(reinterpret_cast<float*>(to.data()), reinterpret_cast<const float*>(from.data()), 
+            from.size() * sizeof(cv::Point3f));
+    }
+}
+
+void convert(const sensor_msgs::PointCloud& from, std::vector<cv::Point3f>& to)
+{
+    convert(from.points, to);
+}
+
+void convert(const std::vector<cv::Point3f>& from, std::vector<geometry_msgs::Point>& to)
+{
+    to.resize(from.size());
+    for(size_t i=0; i<from.size(); i++)
+    {
+        to[i].x = from[i].x;
+        to[i].y = from[i].y;
+        to[i].z = from[i].z;
+    }
+}
+
+void convert(const std::vector<cv::Point3f>& from, std::vector<geometry_msgs::Point32>& to)
+{
+    to.resize(from.size());
+    if(!from.empty())
+    {
+        std::memcpy(reinterpret_cast<float*>(to.data()), reinterpret_cast<const float*>(from.data()), 
+            from.size() * sizeof(cv::Point3f));
+    }
+}
+
+void convert(const std::vector<cv::Point3f>& from, sensor_msgs::PointCloud& to)
+{
+    const size_t n = to.points.size();
+    convert(from, to.points);
+    if(to.points.size() != n)
+    {
+        to.channels.clear();
+    }
+}
+
+cv::Mat wrap(std::vector<geometry_msgs::Point>& points)
+{
+    return cv::Mat(static_cast<int>(points.size()), 3, CV_64F, points.data());
+}
+
+cv::Mat wrap(const std::vector<geometry_msgs::Point>& points)
+{
+    return cv::Mat(static_cast<int>(points.size()), 3, CV_64F, const_cast<geometry_msgs::Point*>(points.data()));
+}
+
+cv::Mat wrap(std::vector<geometry_msgs::Point32>& points)
+{
+    return cv::Mat(static_cast<int>(points.size()), 3, CV_32F, points.data());
+}
+
+cv::Mat wrap(const std::vector<geometry_msgs::Point32>& points)
+{
+    return cv::Mat(static_cast<int>(points.size()), 3, CV_32F, const_cast<geometry_msgs::Point32*>(points.data()));
+}
+
+cv::Mat wrap(sensor_msgs::PointCloud& cloud)
+{
+    return wrap(cloud.points);
+}
+
+cv::Mat wrap(const sensor_msgs::PointCloud& cloud)
+{
+    return wrap(cloud.points);
+}
+
 } // namespace rosmath
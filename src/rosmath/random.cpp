@@ -1,57 +1,467 @@
 #include "Eigen/Dense"
 #include "rosmath/random.h"
 
-#include "rosmath/eigen/conversions.h"
+#include <atomic>
+#include <cstring>
+#include <limits>
 
 namespace rosmath {
 
 namespace random {
 
+namespace {
+
+std::atomic<uint64_t> g_seed(Engine::default_seed);
+// incremented by seed(). engines of an older generation are reseeded
+std::atomic<uint64_t> g_generation(0);
+// per-thread index within the current generation
+std::atomic<uint64_t> g_thread_index(0);
+
+struct ThreadEngine {
+    Engine engine;
+    uint64_t generation = std::numeric_limits<uint64_t>::max();
+};
+
+thread_local ThreadEngine t_engine;
+
+// parallelize counter-based fills above this many elements
+constexpr size_t PARALLEL_MIN_SIZE = 4096;
+
+/**
+ * Elements [offset, offset + size) of the Philox stream. Element i uses 
+ * half (i % 2) of block i / 2, i.e. words (0,1) or (2,3).
+ */
+template<typename Emit>
+void for_each_element(const Philox& gen, size_t offset, size_t size, Emit emit)
+{
+    const int64_t b_begin = offset / 2;
+    const int64_t b_end = (offset + size + 1) / 2;
+
+    #pragma omp parallel for if(size >= PARALLEL_MIN_SIZE)
+    for(int64_t b=b_begin; b<b_end; b++)
+    {
+        const Philox::Block w = gen.block(b);
+        for(size_t h=0; h<2; h++)
+        {
+            const size_t e = 2 * b + h;
+            if(e >= offset && e < offset + size)
+            {
+                emit(e - offset, w, h);
+            }
+        }
+    }
+}
+
+// blocks per tile of the bulk generators
+constexpr size_t TILE = 64;
+
+/**
+ * Elements [offset, offset + size) of the Philox stream, out = a + b * z
+ * 
+ * transform(n, x0, x1, x2, x3, z) maps n blocks to 2n values z
+ */
+template<typename Transform>
+void bulk_fill(const Philox& gen, size_t offset, size_t size, 
+    double a, double b, double* out, Transform transform)
+{
+    if(size == 0)
+    {
+        return;
+    }
+
+    const uint64_t b_begin = offset / 2;
+    const uint64_t b_end = (offset + size + 1) / 2;
+    const int64_t n_tiles = (b_end - b_begin + TILE - 1) / TILE;
+
+    #pragma omp parallel for if(size >= PARALLEL_MIN_SIZE)
+    for(int64_t t=0; t<n_tiles; t++)
+    {
+        alignas(64) uint32_t x0[TILE], x1[TILE], x2[TILE], x3[TILE];
+        alignas(64) double z[2 * TILE];
+
+        const uint64_t first = b_begin + t * TILE;
+        const size_t n = std::min<uint64_t>(TILE, b_end - first);
+        gen.blocks(first, n, x0, x1, x2, x3);
+        transform(n, x0, x1, x2, x3, z);
+
+        // element range of this tile
+        const size_t e0 = 2 * first;
+        const size_t lo = std::max(e0, offset);
+        const size_t hi = std::min(e0 + 2 * n, offset + size);
+        const double* src = z + (lo - e0);
+        double* dst = out + (lo - offset);
+
+        #pragma omp simd
+        for(size_t k=0; k<hi - lo; k++)
+        {
+            dst[k] = a + b * src[k];
+        }
+    }
+}
+
+void uniform_tile(size_t n, 
+    const uint32_t* x0, const uint32_t* x1, const uint32_t* x2, const uint32_t* x3, 
+    double* z)
+{
+    #pragma omp simd
+    for(size_t j=0; j<n; j++)
+    {
+        z[2 * j] = to_unit(x0[j], x1[j]);
+        z[2 * j + 1] = to_unit(x2[j], x3[j]);
+    }
+}
+
+/**
+ * sin(2 pi u), cos(2 pi u) for u in [0, 1) without branches or library 
+ * calls, so the Box-Muller loop vectorizes. Reduction to [-pi/4, pi/4] and Taylor 
+ * polynomials up to x^15 / x^16, absolute error < 5e-16.
+ */
+inline void sincos_2pi(double u, double& s, double& c)
+{
+    // u in [0, 1). truncation of positive values instead of floor vectorizes
+    const double t = (u >= 0.5) ? u - 1.0 : u;              // [-0.5, 0.5)
+    const int q = static_cast<int>(4.0 * t + 2.5) - 2;      // quadrant -2..2
+    const double x = 2.0 * M_PI * (t - 0.25 * q);           // [-pi/4, pi/4]
+    const double x2 = x * x;
+
+    const double sx = x * (1.0 + x2 * (-1.0/6 + x2 * (1.0/120 + x2 * (-1.0/5040 
+        + x2 * (1.0/362880 + x2 * (-1.0/39916800 + x2 * (1.0/6227020800 
+        + x2 * (-1.0/1307674368000))))))));
+    const double cx = 1.0 + x2 * (-0.5 + x2 * (1.0/24 + x2 * (-1.0/720 
+        + x2 * (1.0/40320 + x2 * (-1.0/3628800 + x2 * (1.0/479001600 + x2 * (-1.0/87178291200 
+        + x2 * (1.0/20922789888000))))))));
+
+    // rotate by q * pi/2
+    const int k = q & 3;
+    s = (k == 0) ? sx : (k == 1) ? cx : (k == 2) ? -sx : -cx;
+    c = (k == 0) ? cx : (k == 1) ? -sx : (k == 2) ? -cx : sx;
+}
+
+/**
+ * log(x) for x in (0, 1] without library calls: x = m * 2^e with 
+ * m in [sqrt(0.5), sqrt(2)), log(m) = 2 * atanh((m - 1) / (m + 1)) as a 
+ * series, relative error < 5e-16 (about two ulp).
+ */
+inline double log_unit(double x)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    int64_t e = static_cast<int64_t>((bits >> 52) & 0x7FF) - 1023;
+    bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+    double m;
+    std::memcpy(&m, &bits, sizeof(m));
+    // m in [1, 2) -> [sqrt(0.5), sqrt(2))
+    const bool big = (m > M_SQRT2);
+    m = big ? 0.5 * m : m;
+    e = big ? e + 1 : e;
+
+    const double s = (m - 1.0) / (m + 1.0);
+    const double s2 = s * s;
+    const double series = 1.0 + s2 * (1.0/3 + s2 * (1.0/5 + s2 * (1.0/7 + s2 * (1.0/9 
+        + s2 * (1.0/11 + s2 * (1.0/13 + s2 * (1.0/15 + s2 * (1.0/17 + s2 * (1.0/19 + s2 * (1.0/21))))))))));
+    return 2.0 * s * series + static_cast<double>(e) * M_LN2;
+}
+
+// Box-Muller
+void normal_tile(size_t n, 
+    const uint32_t* x0, const uint32_t* x1, const uint32_t* x2, const uint32_t* x3, 
+    double* z)
+{
+    Eigen::Array<double, Eigen::Dynamic, 1, 0, TILE, 1> r(n), sn(n), cs(n);
+    double* rp = r.data();
+    double* sp = sn.data();
+    double* cp = cs.data();
+
+    #pragma omp simd
+    for(size_t j=0; j<n; j++)
+    {
+        rp[j] = -2.0 * log_unit(1.0 - to_unit(x0[j], x1[j]));
+        sincos_2pi(to_unit(x2[j], x3[j]), sp[j], cp[j]);
+    }
+
+    // vectorized by Eigen
+    r = r.sqrt();
+
+    using Strided = Eigen::Map<Eigen::ArrayXd, 0, Eigen::InnerStride<2> >;
+    Strided(z, n) = r * cs;
+    Strided(z + 1, n) = r * sn;
+}
+
+void philox_uniforms(const Philox& gen, size_t offset, size_t size, double* out)
+{
+    bulk_fill(gen, offset, size, 0.0, 1.0, out, uniform_tile);
+}
+
+void philox_normals(const Philox& gen, size_t offset, size_t size, double* out)
+{
+    bulk_fill(gen, offset, size, 0.0, 1.0, out, normal_tile);
+}
+
+// rotation and translation parts of the batch pose types
+inline geometry_msgs::Quaternion& rotation(geometry_msgs::Quaternion& q) { return q; }
+inline geometry_msgs::Quaternion& rotation(geometry_msgs::Pose& p) { return p.orientation; }
+inline geometry_msgs::Quaternion& rotation(geometry_msgs::Transform& t) { return t.rotation; }
+inline geometry_msgs::Point& translation(geometry_msgs::Pose& p) { return p.position; }
+inline geometry_msgs::Vector3& translation(geometry_msgs::Transform& t) { return t.translation; }
+inline const geometry_msgs::Quaternion& rotation(const geometry_msgs::Pose& p) { return p.orientation; }
+inline const geometry_msgs::Quaternion& rotation(const geometry_msgs::Transform& t) { return t.rotation; }
+inline const geometry_msgs::Point& translation(const geometry_msgs::Pose& p) { return p.position; }
+inline const geometry_msgs::Vector3& translation(const geometry_msgs::Transform& t) { return t.translation; }
+
+/**
+ * Orientations of data from the samples r: element j uses 
+ * r[stride * j], r[stride * j + 1], ...
+ */
+
+// uniform on SO(3) from three uniforms in [0, 1) (Shoemake)
+template<typename T>
+void uniform_rotations(const double* r, size_t stride, std::vector<T>& data)
+{
+    T* d = data.data();
+    const int64_t n = data.size();
+
+    #pragma omp parallel for simd if(n >= static_cast<int64_t>(PARALLEL_MIN_SIZE))
+    for(int64_t j=0; j<n; j++)
+    {
+        const double* u = r + stride * j;
+        double s1, c1, s2, c2;
+        sincos_2pi(u[1], s1, c1);
+        sincos_2pi(u[2], s2, c2);
+        const double a = std::sqrt(1.0 - u[0]);
+        const double b = std::sqrt(u[0]);
+
+        geometry_msgs::Quaternion& q = rotation(d[j]);
+        q.x = a * s1;
+        q.y = a * c1;
+        q.z = b * s2;
+        q.w = b * c2;
+    }
+}
+
+// rotations about a fixed axis from one uniform in [0, 1)
+template<typename T>
+void axis_rotations(const double* r, size_t stride, const geometry_msgs::Vector3& axis, 
+    std::vector<T>& data)
+{
+    const double norm = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+    const double ax = axis.x / norm;
+    const double ay = axis.y / norm;
+    const double az = axis.z / norm;
+    T* d = data.data();
+    const int64_t n = data.size();
+
+    #pragma omp parallel for simd if(n >= static_cast<int64_t>(PARALLEL_MIN_SIZE))
+    for(int64_t j=0; j<n; j++)
+    {
+        // half angle in [0, pi)
+        double s, c;
+        sincos_2pi(0.5 * r[stride * j], s, c);
+
+        geometry_msgs::Quaternion& q = rotation(d[j]);
+        q.x = ax * s;
+        q.y = ay * s;
+        q.z = az * s;
+        q.w = c;
+    }
+}
+
+// mean * normalize(sx z0, sy z1, sz z2, 1) from three standard normals
+template<typename T>
+void normal_rotations(const double* r, size_t stride, const geometry_msgs::Quaternion& mean,
+    const double sx, const double sy, const double sz, 
+    std::vector<T>& data)
+{
+    const double mx = mean.x, my = mean.y, mz = mean.z, mw = mean.w;
+    T* d = data.data();
+    const int64_t n = data.size();
+
+    #pragma omp parallel for simd if(n >= static_cast<int64_t>(PARALLEL_MIN_SIZE))
+    for(int64_t j=0; j<n; j++)
+    {
+        const double* z = r + stride * j;
+        const double x = sx * z[0];
+        const double y = sy * z[1];
+        const double w = sz * z[2];
+        const double inv = 1.0 / std::sqrt(1.0 + x * x + y * y + w * w);
+
+        geometry_msgs::Quaternion& q = rotation(d[j]);
+        q.x = inv * (mw * x + mx + my * w - mz * y);
+        q.y = inv * (mw * y - mx * w + my + mz * x);
+        q.z = inv * (mw * w + mx * y - my * x + mz);
+        q.w = inv * (mw - mx * x - my * y - mz * w);
+    }
+}
+
+// translations a + b * r (componentwise)
+template<typename T, typename V>
+void affine_translations(const double* r, size_t stride, const V& a, const V& b, 
+    std::vector<T>& data)
+{
+    T* d = data.data();
+    const int64_t n = data.size();
+
+    #pragma omp parallel for simd if(n >= static_cast<int64_t>(PARALLEL_MIN_SIZE))
+    for(int64_t j=0; j<n; j++)
+    {
+        const double* u = r + stride * j;
+        auto& t = translation(d[j]);
+        t.x = a.x + b.x * u[0];
+        t.y = a.y + b.y * u[1];
+        t.z = a.z + b.z * u[2];
+    }
+}
+
+template<typename T, typename V>
+void uniform_poses(const Philox& gen, std::vector<T>& data, 
+    const V& tmin, const V& tmax, const geometry_msgs::Vector3* axis, size_t offset)
+{
+    const size_t stride = axis ? 4 : 6;
+    std::vector<double> r(stride * data.size());
+    uniform_fill(gen, r.data(), r.size(), 0.0, 1.0, offset);
+
+    V extent;
+    extent.x = tmax.x - tmin.x;
+    extent.y = tmax.y - tmin.y;
+    extent.z = tmax.z - tmin.z;
+    affine_translations(r.data(), stride, tmin, extent, data);
+    
+    if(axis)
+    {
+        axis_rotations(r.data() + 3, stride, *axis, data);
+    } else {
+        uniform_rotations(r.data() + 3, stride, data);
+    }
+}
+
+template<typename T, typename V>
+void normal_poses(const Philox& gen, std::vector<T>& data, const T& mean, const V& sigma,
+    const double sx, const double sy, const double sz, size_t offset)
+{
+    std::vector<double> r(6 * data.size());
+    normal_fill(gen, r.data(), r.size(), 0.0, 1.0, offset);
+    affine_translations(r.data(), 6, translation(mean), sigma, data);
+    normal_rotations(r.data() + 3, 6, rotation(mean), sx, sy, sz, data);
+}
+
+} // namespace
+
+Engine& engine()
+{
+    const uint64_t generation = g_generation.load(std::memory_order_acquire);
+    if(t_engine.generation != generation)
+    {
+        const uint64_t s = g_seed.load(std::memory_order_relaxed);
+        const uint64_t index = g_thread_index.fetch_add(1);
+        std::seed_seq seq{
+            static_cast<uint32_t>(s), static_cast<uint32_t>(s >> 32),
+            static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32)};
+        t_engine.engine.seed(seq);
+        t_engine.generation = generation;
+    }
+    return t_engine.engine;
+}
+
+void seed(size_t seed)
+{
+    g_seed.store(seed, std::memory_order_relaxed);
+    g_thread_index.store(0);
+    g_generation.fetch_add(1, std::memory_order_release);
+}
+
+Philox thread_philox()
+{
+    return Philox(engine()());
+}
+
+size_t uniform_number(
+    const size_t min,
+    const size_t max)
+{
+    return uniform_number(engine(), min, max);
+}
+
 size_t uniform_number(
+    Engine& gen,
     const size_t min,
     const size_t max)
 {
-    return std::uniform_int_distribution<size_t>(min, max)(engine);
+    return std::uniform_int_distribution<size_t>(min, max)(gen);
+}
+
+std::vector<size_t> uniform_numbers(
+    const size_t min,
+    const size_t max,
+    const size_t size)
+{
+    return uniform_numbers(engine(), min, max, size);
 }
 
 std::vector<size_t> uniform_numbers(
+    Engine& gen,
     const size_t min,
     const size_t max,
     const size_t size)
 {
     std::vector<size_t> ret(size);
-    uniform_fill(ret, min, max);
+    uniform_fill(gen, ret, min, max);
     return ret;
 }
 
 double uniform_number(const double min, const double max)
 {
-    return std::uniform_real_distribution<double>(min, max)(engine);
+    return uniform_number(engine(), min, max);
+}
+
+double uniform_number(Engine& gen, const double min, const double max)
+{
+    return std::uniform_real_distribution<double>(min, max)(gen);
+}
+
+std::vector<double> uniform_numbers(
+    const double min, 
+    const double max, 
+    const size_t size)
+{
+    return uniform_numbers(engine(), min, max, size);
 }
 
 std::vector<double> uniform_numbers(
+    Engine& gen,
     const double min, 
     const double max, 
     const size_t size)
 {
     std::vector<double> ret(size);
-    uniform_fill(ret, min, max);
+    uniform_fill(gen, ret, min, max);
     return ret;
 }
 
 double uniform_angle()
 {
-    return uniform_number(-M_PI, M_PI);
+    return uniform_angle(engine());
+}
+
+double uniform_angle(Engine& gen)
+{
+    return uniform_number(gen, -M_PI, M_PI);
+}
+
+geometry_msgs::Point uniform_point(
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax) 
+{
+    return uniform_point(engine(), pmin, pmax);
 }
 
 geometry_msgs::Point uniform_point(
+    Engine& gen,
     const geometry_msgs::Point pmin, 
     const geometry_msgs::Point pmax) 
 {
     geometry_msgs::Point p;
-    p.x = uniform_number(pmin.x, pmax.x);
-    p.y = uniform_number(pmin.y, pmax.y);
-    p.z = uniform_number(pmin.z, pmax.z);
+    p.x = uniform_number(gen, pmin.x, pmax.x);
+    p.y = uniform_number(gen, pmin.y, pmax.y);
+    p.z = uniform_number(gen, pmin.z, pmax.z);
     return p;
 }
 
@@ -59,18 +469,32 @@ std::vector<geometry_msgs::Point> uniform_points(
     const geometry_msgs::Point pmin, 
     const geometry_msgs::Point pmax,
     size_t size)
+{
+    return uniform_points(engine(), pmin, pmax, size);
+}
+
+std::vector<geometry_msgs::Point> uniform_points(
+    Engine& gen,
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax,
+    size_t size)
 {
     std::vector<geometry_msgs::Point> points(size);
-    uniform_fill(points, pmin, pmax);
+    uniform_fill(gen, points, pmin, pmax);
     return points;
 }
 
 geometry_msgs::Quaternion uniform_quaternion()
+{
+    return uniform_quaternion(engine());
+}
+
+geometry_msgs::Quaternion uniform_quaternion(Engine& gen)
 {
     geometry_msgs::Quaternion ret;
-    double u = uniform_number(0.0, 1.0);
-    double v = uniform_number(0.0, 1.0);
-    double w = uniform_number(0.0, 1.0);
+    double u = uniform_number(gen, 0.0, 1.0);
+    double v = uniform_number(gen, 0.0, 1.0);
+    double w = uniform_number(gen, 0.0, 1.0);
 
     ret.x = sqrt(1-u) * sin(2*M_PI * v);
     ret.y = sqrt(1-u) * cos(2*M_PI * v);
@@ -84,12 +508,21 @@ geometry_msgs::Quaternion uniform_quaternion()
 geometry_msgs::Quaternion uniform_quaternion(
     const geometry_msgs::Vector3 axis)
 {
-    Eigen::Vector3d axis_eig;
-    axis_eig <<= axis;
-    Eigen::Quaterniond q_eig;
-    q_eig = Eigen::AngleAxisd(uniform_angle(), axis_eig);
+    return uniform_quaternion(engine(), axis);
+}
+
+geometry_msgs::Quaternion uniform_quaternion(
+    Engine& gen,
+    const geometry_msgs::Vector3 axis)
+{
+    const double half = 0.5 * uniform_angle(gen);
+    const double s = sin(half) / sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+
     geometry_msgs::Quaternion q;
-    q <<= q_eig;
+    q.x = s * axis.x;
+    q.y = s * axis.y;
+    q.z = s * axis.z;
+    q.w = cos(half);
     return q;
 }
 
@@ -97,52 +530,87 @@ void uniform_fill(
     std::vector<size_t>& data, 
     const size_t min,
     const size_t max)
+{
+    uniform_fill(engine(), data, min, max);
+}
+
+void uniform_fill(
+    Engine& gen,
+    std::vector<size_t>& data, 
+    const size_t min,
+    const size_t max)
 {
     std::uniform_int_distribution<size_t> dist(min, max);
-    std::generate(data.begin(), data.end(), [&dist](){
-                   return dist(engine);
+    std::generate(data.begin(), data.end(), [&dist, &gen](){
+                   return dist(gen);
                });
 }
 
 void uniform_fill(std::vector<double>& data, const double min, const double max)
+{
+    uniform_fill(data.data(), data.size(), min, max);
+}
+
+void uniform_fill(Engine& gen, std::vector<double>& data, const double min, const double max)
 {
     std::uniform_real_distribution<double> dist(min, max);
-    std::generate(data.begin(), data.end(), [&dist](){
-                   return dist(engine);
+    std::generate(data.begin(), data.end(), [&dist, &gen](){
+                   return dist(gen);
                });
 }
 
 void uniform_fill(std::vector<geometry_msgs::Point>& data, 
     const geometry_msgs::Point pmin, 
     const geometry_msgs::Point pmax)
+{
+    uniform_fill(engine(), data, pmin, pmax);
+}
+
+void uniform_fill(Engine& gen,
+    std::vector<geometry_msgs::Point>& data, 
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax)
 {
     std::uniform_real_distribution<double> distx(pmin.x, pmax.x);
     std::uniform_real_distribution<double> disty(pmin.y, pmax.y);
     std::uniform_real_distribution<double> distz(pmin.z, pmax.z);
 
-    std::generate(data.begin(), data.end(), [&distx, &disty, &distz](){
+    std::generate(data.begin(), data.end(), [&distx, &disty, &distz, &gen](){
                     geometry_msgs::Point p;
-                    p.x = distx(engine);
-                    p.y = disty(engine);
-                    p.z = distz(engine);
+                    p.x = distx(gen);
+                    p.y = disty(gen);
+                    p.z = distz(gen);
                     return p;
                });
 }
 
 double normal_number(const double mu, const double sigma)
 {
-    return std::normal_distribution<double>(mu, sigma)(engine);
+    return normal_number(engine(), mu, sigma);
+}
+
+double normal_number(Engine& gen, const double mu, const double sigma)
+{
+    return std::normal_distribution<double>(mu, sigma)(gen);
 }
 
 geometry_msgs::Point normal_point(
     const geometry_msgs::Point mu,
     const geometry_msgs::Point sigma)
+{
+    return normal_point(engine(), mu, sigma);
+}
+
+geometry_msgs::Point normal_point(
+    Engine& gen,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma)
 {
     geometry_msgs::Point ret;
 
-    ret.x = std::normal_distribution<double>(mu.x, sigma.x)(engine);
-    ret.y = std::normal_distribution<double>(mu.y, sigma.y)(engine);
-    ret.z = std::normal_distribution<double>(mu.z, sigma.z)(engine);
+    ret.x = std::normal_distribution<double>(mu.x, sigma.x)(gen);
+    ret.y = std::normal_distribution<double>(mu.y, sigma.y)(gen);
+    ret.z = std::normal_distribution<double>(mu.z, sigma.z)(gen);
 
     return ret;
 }
@@ -151,12 +619,21 @@ geometry_msgs::Quaternion normal_quaternion(
     const double sx,
     const double sy,
     const double sz)
+{
+    return normal_quaternion(engine(), sx, sy, sz);
+}
+
+geometry_msgs::Quaternion normal_quaternion(
+    Engine& gen,
+    const double sx,
+    const double sy,
+    const double sz)
 {
     geometry_msgs::Quaternion q;
 
-    q.x = std::normal_distribution<double>(0.0, sx)(engine);
-    q.y = std::normal_distribution<double>(0.0, sy)(engine);
-    q.z = std::normal_distribution<double>(0.0, sz)(engine);
+    q.x = std::normal_distribution<double>(0.0, sx)(gen);
+    q.y = std::normal_distribution<double>(0.0, sy)(gen);
+    q.z = std::normal_distribution<double>(0.0, sz)(gen);
     q.w = 1.0;
 
     normalize(q);
@@ -168,9 +645,18 @@ std::vector<double> normal_numbers(
     const double mu, 
     const double sigma, 
     const size_t size)
+{
+    return normal_numbers(engine(), mu, sigma, size);
+}
+
+std::vector<double> normal_numbers(
+    Engine& gen,
+    const double mu, 
+    const double sigma, 
+    const size_t size)
 {
     std::vector<double> ret(size);
-    normal_fill(ret, mu, sigma);
+    normal_fill(gen, ret, mu, sigma);
     return ret;
 }
 
@@ -178,9 +664,18 @@ std::vector<geometry_msgs::Point> normal_points(
     const geometry_msgs::Point mu,
     const geometry_msgs::Point sigma,
     const size_t size)
+{
+    return normal_points(engine(), mu, sigma, size);
+}
+
+std::vector<geometry_msgs::Point> normal_points(
+    Engine& gen,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma,
+    const size_t size)
 {
     std::vector<geometry_msgs::Point> ret(size);
-    normal_fill(ret, mu, sigma);
+    normal_fill(gen, ret, mu, sigma);
     return ret;
 }
 
@@ -188,12 +683,30 @@ void normal_fill(
     std::vector<double>& data,
     const double mu,
     const double sigma)
+{
+    normal_fill(data.data(), data.size(), mu, sigma);
+}
+
+void normal_fill(
+    Engine& gen,
+    std::vector<double>& data,
+    const double mu,
+    const double sigma)
 {
     std::normal_distribution<double> dist(mu, sigma);
-    std::generate(data.begin(), data.end(), [&dist](){return dist(engine);});
+    std::generate(data.begin(), data.end(), [&dist, &gen](){return dist(gen);});
+}
+
+void normal_fill(
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma)
+{
+    normal_fill(engine(), data, mu, sigma);
 }
 
 void normal_fill(
+    Engine& gen,
     std::vector<geometry_msgs::Point>& data,
     const geometry_msgs::Point mu,
     const geometry_msgs::Point sigma)
@@ -202,15 +715,439 @@ void normal_fill(
     std::normal_distribution<double> disty(mu.y, sigma.y);
     std::normal_distribution<double> distz(mu.z, sigma.z);
 
-    std::generate(data.begin(), data.end(), [&distx, &disty, &distz](){
+    std::generate(data.begin(), data.end(), [&distx, &disty, &distz, &gen](){
             geometry_msgs::Point p;
-            p.x = distx(engine);
-            p.y = disty(engine);
-            p.z = distz(engine);
+            p.x = distx(gen);
+            p.y = disty(gen);
+            p.z = distz(gen);
             return p;
         });
 }
 
+void uniform_fill(
+    const Philox& gen,
+    std::vector<size_t>& data, 
+    const size_t min,
+    const size_t max,
+    const size_t offset)
+{
+    // multiply-shift on 64 bit words: no rejection, so elements stay 
+    // addressable. the bias is below range / 2^64
+    const size_t range = max - min + 1;
+    size_t* out = data.data();
+    for_each_element(gen, offset, data.size(), [out, min, range](size_t k, const Philox::Block& w, size_t h) {
+        const uint64_t x = (static_cast<uint64_t>(w[2 * h]) << 32) | w[2 * h + 1];
+        out[k] = (range == 0) ? x 
+            : min + static_cast<size_t>(mul_hi(x, range));
+    });
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<double>& data, 
+    const double min,
+    const double max,
+    const size_t offset)
+{
+    uniform_fill(gen, data.data(), data.size(), min, max, offset);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Point>& data, 
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax,
+    const size_t offset)
+{
+    std::vector<double> u(data.size() * 3);
+    philox_uniforms(gen, offset * 3, u.size(), u.data());
+    for(size_t i=0; i<data.size(); i++)
+    {
+        data[i].x = pmin.x + u[3 * i + 0] * (pmax.x - pmin.x);
+        data[i].y = pmin.y + u[3 * i + 1] * (pmax.y - pmin.y);
+        data[i].z = pmin.z + u[3 * i + 2] * (pmax.z - pmin.z);
+    }
+}
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<double>& data,
+    const double mu,
+    const double sigma,
+    const size_t offset)
+{
+    normal_fill(gen, data.data(), data.size(), mu, sigma, offset);
+}
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma,
+    const size_t offset)
+{
+    std::vector<double> n(data.size() * 3);
+    philox_normals(gen, offset * 3, n.size(), n.data());
+    for(size_t i=0; i<data.size(); i++)
+    {
+        data[i].x = mu.x + n[3 * i + 0] * sigma.x;
+        data[i].y = mu.y + n[3 * i + 1] * sigma.y;
+        data[i].z = mu.z + n[3 * i + 2] * sigma.z;
+    }
+}
+
+std::vector<double> uniform_numbers(
+    const Philox& gen,
+    const double min,
+    const double max,
+    const size_t size,
+    const size_t offset)
+{
+    std::vector<double> ret(size);
+    uniform_fill(gen, ret, min, max, offset);
+    return ret;
+}
+
+std::vector<geometry_msgs::Point> uniform_points(
+    const Philox& gen,
+    const geometry_msgs::Point pmin, 
+    const geometry_msgs::Point pmax,
+    const size_t size,
+    const size_t offset)
+{
+    std::vector<geometry_msgs::Point> ret(size);
+    uniform_fill(gen, ret, pmin, pmax, offset);
+    return ret;
+}
+
+std::vector<double> normal_numbers(
+    const Philox& gen,
+    const double mu, 
+    const double sigma,
+    const size_t size,
+    const size_t offset)
+{
+    std::vector<double> ret(size);
+    normal_fill(gen, ret, mu, sigma, offset);
+    return ret;
+}
+
+std::vector<geometry_msgs::Point> normal_points(
+    const Philox& gen,
+    const geometry_msgs::Point mu,
+    const geometry_msgs::Point sigma,
+    const size_t size,
+    const size_t offset)
+{
+    std::vector<geometry_msgs::Point> ret(size);
+    normal_fill(gen, ret, mu, sigma, offset);
+    return ret;
+}
+
+void uniform_fill(
+    const Philox& gen,
+    double* data,
+    const size_t size,
+    const double min,
+    const double max,
+    const size_t offset)
+{
+    bulk_fill(gen, offset, size, min, max - min, data, uniform_tile);
+}
+
+void normal_fill(
+    const Philox& gen,
+    double* data,
+    const size_t size,
+    const double mu,
+    const double sigma,
+    const size_t offset)
+{
+    bulk_fill(gen, offset, size, mu, sigma, data, normal_tile);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max,
+    const size_t offset)
+{
+    uniform_fill(gen, data.data(), data.size(), min, max, offset);
+}
+
+void normal_fill(
+    const Philox& gen,
+    Eigen::MatrixXd& data,
+    const double mu,
+    const double sigma,
+    const size_t offset)
+{
+    normal_fill(gen, data.data(), data.size(), mu, sigma, offset);
+}
+
+void uniform_fill(
+    double* data,
+    const size_t size,
+    const double min,
+    const double max)
+{
+    uniform_fill(thread_philox(), data, size, min, max);
+}
+
+void normal_fill(
+    double* data,
+    const size_t size,
+    const double mu,
+    const double sigma)
+{
+    normal_fill(thread_philox(), data, size, mu, sigma);
+}
+
+void uniform_fill(
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max)
+{
+    uniform_fill(thread_philox(), data, min, max);
+}
+
+void normal_fill(
+    Eigen::MatrixXd& data,
+    const double mu,
+    const double sigma)
+{
+    normal_fill(thread_philox(), data, mu, sigma);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const size_t offset)
+{
+    std::vector<double> r(3 * data.size());
+    uniform_fill(gen, r.data(), r.size(), 0.0, 1.0, offset);
+    uniform_rotations(r.data(), 3, data);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset)
+{
+    std::vector<double> r(data.size());
+    uniform_fill(gen, r.data(), r.size(), 0.0, 1.0, offset);
+    axis_rotations(r.data(), 1, axis, data);
+}
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const double sx, const double sy, const double sz,
+    const size_t offset)
+{
+    std::vector<double> r(3 * data.size());
+    normal_fill(gen, r.data(), r.size(), 0.0, 1.0, offset);
+    geometry_msgs::Quaternion identity;
+    identity.w = 1.0;
+    normal_rotations(r.data(), 3, identity, sx, sy, sz, data);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset)
+{
+    uniform_poses(gen, data, pmin, pmax, nullptr, offset);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset)
+{
+    uniform_poses(gen, data, pmin, pmax, &axis, offset);
+}
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz,
+    const size_t offset)
+{
+    normal_poses(gen, data, mean, sigma, sx, sy, sz, offset);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset)
+{
+    uniform_fill(gen, data.poses, pmin, pmax, offset);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset)
+{
+    uniform_fill(gen, data.poses, pmin, pmax, axis, offset);
+}
+
+void normal_fill(
+    const Philox& gen,
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz,
+    const size_t offset)
+{
+    normal_fill(gen, data.poses, mean, sigma, sx, sy, sz, offset);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax,
+    const size_t offset)
+{
+    uniform_poses(gen, data, tmin, tmax, nullptr, offset);
+}
+
+void uniform_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax,
+    const geometry_msgs::Vector3 axis,
+    const size_t offset)
+{
+    uniform_poses(gen, data, tmin, tmax, &axis, offset);
+}
+
+void normal_fill(
+    const Philox& gen,
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Transform mean,
+    const geometry_msgs::Vector3 sigma,
+    const double sx, const double sy, const double sz,
+    const size_t offset)
+{
+    normal_poses(gen, data, mean, sigma, sx, sy, sz, offset);
+}
+
+void uniform_fill(
+    std::vector<geometry_msgs::Quaternion>& data)
+{
+    uniform_fill(thread_philox(), data);
+}
+
+void uniform_fill(
+    std::vector<geometry_msgs::Quaternion>& data,
+    const geometry_msgs::Vector3 axis)
+{
+    uniform_fill(thread_philox(), data, axis);
+}
+
+void normal_fill(
+    std::vector<geometry_msgs::Quaternion>& data,
+    const double sx, const double sy, const double sz)
+{
+    normal_fill(thread_philox(), data, sx, sy, sz);
+}
+
+void uniform_fill(
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax)
+{
+    uniform_fill(thread_philox(), data, pmin, pmax);
+}
+
+void uniform_fill(
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis)
+{
+    uniform_fill(thread_philox(), data, pmin, pmax, axis);
+}
+
+void normal_fill(
+    std::vector<geometry_msgs::Pose>& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz)
+{
+    normal_fill(thread_philox(), data, mean, sigma, sx, sy, sz);
+}
+
+void uniform_fill(
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax)
+{
+    uniform_fill(thread_philox(), data, pmin, pmax);
+}
+
+void uniform_fill(
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const geometry_msgs::Vector3 axis)
+{
+    uniform_fill(thread_philox(), data, pmin, pmax, axis);
+}
+
+void normal_fill(
+    geometry_msgs::PoseArray& data,
+    const geometry_msgs::Pose mean,
+    const geometry_msgs::Point sigma,
+    const double sx, const double sy, const double sz)
+{
+    normal_fill(thread_philox(), data, mean, sigma, sx, sy, sz);
+}
+
+void uniform_fill(
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax)
+{
+    uniform_fill(thread_philox(), data, tmin, tmax);
+}
+
+void uniform_fill(
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Vector3 tmin,
+    const geometry_msgs::Vector3 tmax,
+    const geometry_msgs::Vector3 axis)
+{
+    uniform_fill(thread_philox(), data, tmin, tmax, axis);
+}
+
+void normal_fill(
+    std::vector<geometry_msgs::Transform>& data,
+    const geometry_msgs::Transform mean,
+    const geometry_msgs::Vector3 sigma,
+    const double sx, const double sy, const double sz)
+{
+    normal_fill(thread_philox(), data, mean, sigma, sx, sy, sz);
+}
+
 } // namespace random
 
-} // namespace rosmath
\ No newline at end of file
+} // namespace rosmath
@@ -0,0 +1,393 @@
+#include "rosmath/random/lowdiscrepancy.h"
+#include "rosmath/random.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace rosmath {
+
+namespace random {
+
+namespace {
+
+// parallelize fills above this many points
+constexpr size_t PARALLEL_MIN_POINTS = 4096;
+// points per chunk of parallel Sobol fills
+constexpr size_t SOBOL_CHUNK = 1024;
+
+// primitive polynomial degree s, coefficients a and initial m of dimensions 2, 3, ...
+struct SobolInit {
+    uint32_t s;
+    uint32_t a;
+    uint32_t m[8];
+};
+
+// new-joe-kuo-6.21201
+const SobolInit JOE_KUO[Sobol::MAX_DIMENSIONS - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+    {7, 4, {1, 3, 7, 13, 13, 15, 69}}
+};
+
+const uint32_t PRIMES[Halton::MAX_DIMENSIONS] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73
+};
+
+constexpr double TWO_POW_M32 = 1.0 / 4294967296.0;
+
+void check_dimensions(const size_t dims, const size_t max, const std::string& name)
+{
+    if(dims == 0 || dims > max)
+    {
+        throw std::runtime_error(name + ": dimensions must be in [1, "
+            + std::to_string(max) + "], got " + std::to_string(dims));
+    }
+}
+
+template<typename Sequence>
+void require_dimensions(const Sequence& seq, const size_t dims)
+{
+    if(seq.dimensions() < dims)
+    {
+        throw std::runtime_error("low discrepancy sequence: "
+            + std::to_string(dims) + " dimensions required, sequence has "
+            + std::to_string(seq.dimensions()));
+    }
+}
+
+template<typename Sequence>
+void fill_points(const Sequence& seq, std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point& pmin, const geometry_msgs::Point& pmax, size_t offset)
+{
+    require_dimensions(seq, 3);
+    const size_t dims = seq.dimensions();
+    std::vector<double> u(dims * data.size());
+    seq.fill(offset, data.size(), u.data());
+
+    for(size_t k=0; k<data.size(); k++)
+    {
+        const double* x = u.data() + dims * k;
+        data[k].x = pmin.x + (pmax.x - pmin.x) * x[0];
+        data[k].y = pmin.y + (pmax.y - pmin.y) * x[1];
+        data[k].z = pmin.z + (pmax.z - pmin.z) * x[2];
+    }
+}
+
+template<typename Sequence>
+void fill_quaternions(const Sequence& seq, std::vector<geometry_msgs::Quaternion>& data, size_t offset)
+{
+    require_dimensions(seq, 3);
+    const size_t dims = seq.dimensions();
+    std::vector<double> u(dims * data.size());
+    seq.fill(offset, data.size(), u.data());
+
+    for(size_t k=0; k<data.size(); k++)
+    {
+        const double* x = u.data() + dims * k;
+        const double a = std::sqrt(1.0 - x[0]);
+        const double b = std::sqrt(x[0]);
+        data[k].x = a * sin(2.0 * M_PI * x[1]);
+        data[k].y = a * cos(2.0 * M_PI * x[1]);
+        data[k].z = b * sin(2.0 * M_PI * x[2]);
+        data[k].w = b * cos(2.0 * M_PI * x[2]);
+    }
+}
+
+template<typename Sequence>
+void fill_matrix(const Sequence& seq, Eigen::MatrixXd& data,
+    const double min, const double max, size_t offset)
+{
+    require_dimensions(seq, data.rows());
+    const size_t dims = seq.dimensions();
+
+    if(static_cast<size_t>(data.rows()) == dims)
+    {
+        seq.fill(offset, data.cols(), data.data());
+    } else {
+        Eigen::MatrixXd U(dims, data.cols());
+        seq.fill(offset, data.cols(), U.data());
+        data = U.topRows(data.rows());
+    }
+
+    data = (data.array() * (max - min) + min).matrix();
+}
+
+} // namespace
+
+Sobol::Sobol(
+    const size_t dimensions,
+    const bool scramble,
+    const uint64_t seed)
+:m_dims(dimensions)
+,m_v(dimensions)
+,m_shift(dimensions, 0)
+{
+    check_dimensions(dimensions, MAX_DIMENSIONS, "Sobol");
+
+    // first dimension: van der Corput in base 2
+    for(size_t k=0; k<32; k++)
+    {
+        m_v[0][k] = 1u << (31 - k);
+    }
+
+    for(size_t d=1; d<m_dims; d++)
+    {
+        const SobolInit& init = JOE_KUO[d - 1];
+        std::array<uint32_t, 32>& v = m_v[d];
+
+        for(size_t k=0; k<init.s; k++)
+        {
+            v[k] = init.m[k] << (31 - k);
+        }
+
+        for(size_t k=init.s; k<32; k++)
+        {
+            v[k] = v[k - init.s] ^ (v[k - init.s] >> init.s);
+            for(size_t j=1; j<init.s; j++)
+            {
+                if((init.a >> (init.s - 1 - j)) & 1u)
+                {
+                    v[k] ^= v[k - j];
+                }
+            }
+        }
+    }
+
+    if(scramble)
+    {
+        Engine gen(seed);
+        for(size_t d=0; d<m_dims; d++)
+        {
+            m_shift[d] = static_cast<uint32_t>(gen() >> 32);
+        }
+    }
+}
+
+size_t Sobol::dimensions() const
+{
+    return m_dims;
+}
+
+double Sobol::value(const uint64_t index, const size_t dim) const
+{
+    const std::array<uint32_t, 32>& v = m_v[dim];
+    const uint64_t i = index & 0xFFFFFFFFu;
+    uint64_t gray = i ^ (i >> 1);
+    uint32_t x = m_shift[dim];
+    for(size_t k=0; gray != 0 && k<32; k++, gray >>= 1)
+    {
+        if(gray & 1u)
+        {
+            x ^= v[k];
+        }
+    }
+    return x * TWO_POW_M32;
+}
+
+void Sobol::fill(const uint64_t offset, const size_t size, double* out) const
+{
+    const int64_t n_chunks = (size + SOBOL_CHUNK - 1) / SOBOL_CHUNK;
+
+    #pragma omp parallel for if(size >= PARALLEL_MIN_POINTS)
+    for(int64_t c=0; c<n_chunks; c++)
+    {
+        const size_t begin = c * SOBOL_CHUNK;
+        const size_t end = std::min(begin + SOBOL_CHUNK, size);
+
+        // first point of the chunk directly, then Gray code steps:
+        // point i + 1 differs from point i by direction number ctz(i + 1)
+        std::vector<uint32_t> x(m_dims);
+        const uint64_t first = (offset + begin) & 0xFFFFFFFFu;
+        const uint64_t gray = first ^ (first >> 1);
+        for(size_t d=0; d<m_dims; d++)
+        {
+            x[d] = m_shift[d];
+            for(size_t k=0; k<32; k++)
+            {
+                if((gray >> k) & 1u)
+                {
+                    x[d] ^= m_v[d][k];
+                }
+            }
+        }
+
+        for(size_t i=begin; i<end; i++)
+        {
+            double* p = out + i * m_dims;
+            for(size_t d=0; d<m_dims; d++)
+            {
+                p[d] = x[d] * TWO_POW_M32;
+            }
+
+            // at the wrap to index 2^32 the Gray code flips bit 31
+            const size_t k = std::min<uint64_t>(count_trailing_zeros(offset + i + 1), 31);
+            for(size_t d=0; d<m_dims; d++)
+            {
+                x[d] ^= m_v[d][k];
+            }
+        }
+    }
+}
+
+Halton::Halton(
+    const size_t dimensions,
+    const bool scramble,
+    const uint64_t seed)
+:m_dims(dimensions)
+,m_perm(dimensions)
+{
+    check_dimensions(dimensions, MAX_DIMENSIONS, "Halton");
+
+    Engine gen(seed);
+    for(size_t d=0; d<m_dims; d++)
+    {
+        std::vector<uint32_t>& perm = m_perm[d];
+        perm.resize(PRIMES[d]);
+        for(uint32_t i=0; i<perm.size(); i++)
+        {
+            perm[i] = i;
+        }
+
+        if(scramble)
+        {
+            // 0 stays fixed: the infinitely many leading zero digits
+            std::shuffle(perm.begin() + 1, perm.end(), gen);
+        }
+    }
+}
+
+size_t Halton::dimensions() const
+{
+    return m_dims;
+}
+
+double Halton::value(const uint64_t index, const size_t dim) const
+{
+    const uint32_t base = PRIMES[dim];
+    const std::vector<uint32_t>& perm = m_perm[dim];
+    const double inv_base = 1.0 / base;
+
+    double x = 0.0;
+    double f = inv_base;
+    for(uint64_t i=index; i>0; i/=base)
+    {
+        x += perm[i % base] * f;
+        f *= inv_base;
+    }
+    return x;
+}
+
+void Halton::fill(const uint64_t offset, const size_t size, double* out) const
+{
+    #pragma omp parallel for if(size >= PARALLEL_MIN_POINTS)
+    for(int64_t k=0; k<static_cast<int64_t>(size); k++)
+    {
+        double* p = out + k * m_dims;
+        for(size_t d=0; d<m_dims; d++)
+        {
+            p[d] = value(offset + k, d);
+        }
+    }
+}
+
+void uniform_fill(
+    const Sobol& seq,
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset)
+{
+    fill_points(seq, data, pmin, pmax, offset);
+}
+
+void uniform_fill(
+    const Sobol& seq,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const size_t offset)
+{
+    fill_quaternions(seq, data, offset);
+}
+
+void uniform_fill(
+    const Sobol& seq,
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max,
+    const size_t offset)
+{
+    fill_matrix(seq, data, min, max, offset);
+}
+
+std::vector<geometry_msgs::Point> uniform_points(
+    const Sobol& seq,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t size,
+    const size_t offset)
+{
+    std::vector<geometry_msgs::Point> points(size);
+    uniform_fill(seq, points, pmin, pmax, offset);
+    return points;
+}
+
+void uniform_fill(
+    const Halton& seq,
+    std::vector<geometry_msgs::Point>& data,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t offset)
+{
+    fill_points(seq, data, pmin, pmax, offset);
+}
+
+void uniform_fill(
+    const Halton& seq,
+    std::vector<geometry_msgs::Quaternion>& data,
+    const size_t offset)
+{
+    fill_quaternions(seq, data, offset);
+}
+
+void uniform_fill(
+    const Halton& seq,
+    Eigen::MatrixXd& data,
+    const double min,
+    const double max,
+    const size_t offset)
+{
+    fill_matrix(seq, data, min, max, offset);
+}
+
+std::vector<geometry_msgs::Point> uniform_points(
+    const Halton& seq,
+    const geometry_msgs::Point pmin,
+    const geometry_msgs::Point pmax,
+    const size_t size,
+    const size_t offset)
+{
+    std::vector<geometry_msgs::Point> points(size);
+    uniform_fill(seq, points, pmin, pmax, offset);
+    return points;
+}
+
+} // namespace random
+
+} // namespace rosmath
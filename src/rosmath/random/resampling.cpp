@@ -0,0 +1,275 @@
+#include "rosmath/random/resampling.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace rosmath {
+
+namespace random {
+
+namespace {
+
+struct WeightSummary {
+    double total;
+    // last index with a positive weight
+    size_t last;
+};
+
+WeightSummary summarize(const std::vector<double>& weights)
+{
+    WeightSummary summary{0.0, 0};
+
+    for(size_t i=0; i<weights.size(); i++)
+    {
+        const double w = weights[i];
+        if(!(w >= 0.0) || std::isinf(w))
+        {
+            throw std::runtime_error("resample: weights must be finite and non-negative");
+        }
+        if(w > 0.0)
+        {
+            summary.total += w;
+            summary.last = i;
+        }
+    }
+
+    if(!(summary.total > 0.0))
+    {
+        throw std::runtime_error("resample: weights must have a positive sum");
+    }
+
+    return summary;
+}
+
+/**
+ * Indices of the nondecreasing uniforms u(k) in [0, 1) under the
+ * (unnormalized) weights w: a single pass over the weights.
+ */
+template<typename Uniforms>
+void walk(const double* w, const WeightSummary& summary,
+    size_t size, Uniforms u, size_t* out)
+{
+    size_t j = 0;
+    double c = w[0];
+    for(size_t k=0; k<size; k++)
+    {
+        const double t = u(k) * summary.total;
+        while(t >= c && j < summary.last)
+        {
+            j++;
+            c += w[j];
+        }
+        out[k] = j;
+    }
+}
+
+/**
+ * size sorted uniforms in O(size) from normalized exponential spacings
+ * into sorted (size + 1 values are used)
+ */
+void sorted_uniforms(Engine& gen, size_t size, std::vector<double>& sorted)
+{
+    sorted.resize(size + 1);
+    std::exponential_distribution<double> exponential(1.0);
+    double sum = 0.0;
+    for(size_t k=0; k<=size; k++)
+    {
+        sum += exponential(gen);
+        sorted[k] = sum;
+    }
+    const double inv = 1.0 / sum;
+    for(size_t k=0; k<size; k++)
+    {
+        sorted[k] *= inv;
+    }
+}
+
+} // namespace
+
+double effective_sample_size(const std::vector<double>& weights)
+{
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for(const double w : weights)
+    {
+        sum += w;
+        sum_sq += w * w;
+    }
+    return (sum_sq > 0.0) ? sum * sum / sum_sq : 0.0;
+}
+
+Resampler::Resampler(const Resampling method)
+:m_method(method)
+{
+
+}
+
+Resampling Resampler::method() const
+{
+    return m_method;
+}
+
+void Resampler::resample(
+    Engine& gen,
+    const std::vector<double>& weights,
+    const size_t size,
+    std::vector<size_t>& indices)
+{
+    const WeightSummary summary = summarize(weights);
+    indices.resize(size);
+    if(size == 0)
+    {
+        return;
+    }
+
+    const double* w = weights.data();
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double inv_size = 1.0 / size;
+
+    switch(m_method)
+    {
+        case Resampling::MULTINOMIAL: {
+            sorted_uniforms(gen, size, m_uniforms);
+            const double* u = m_uniforms.data();
+            walk(w, summary, size, [u](size_t k) { return u[k]; }, indices.data());
+            break;
+        }
+        case Resampling::STRATIFIED: {
+            walk(w, summary, size, [&](size_t k) {
+                return (k + uniform(gen)) * inv_size;
+            }, indices.data());
+            break;
+        }
+        case Resampling::SYSTEMATIC: {
+            const double offset = uniform(gen);
+            walk(w, summary, size, [offset, inv_size](size_t k) {
+                return (k + offset) * inv_size;
+            }, indices.data());
+            break;
+        }
+        case Resampling::RESIDUAL: {
+            // deterministic copies
+            m_residuals.resize(weights.size());
+            const double scale = size / summary.total;
+            size_t n_copies = 0;
+            for(size_t i=0; i<weights.size(); i++)
+            {
+                const double expected = scale * w[i];
+                const size_t copies = std::min<size_t>(std::floor(expected), size - n_copies);
+                for(size_t c=0; c<copies; c++)
+                {
+                    indices[n_copies++] = i;
+                }
+                m_residuals[i] = expected - copies;
+            }
+
+            // multinomial on the residual weights
+            const size_t n_rest = size - n_copies;
+            if(n_rest > 0)
+            {
+                WeightSummary residual{0.0, 0};
+                for(size_t i=0; i<m_residuals.size(); i++)
+                {
+                    if(m_residuals[i] > 0.0)
+                    {
+                        residual.total += m_residuals[i];
+                        residual.last = i;
+                    }
+                }
+
+                sorted_uniforms(gen, n_rest, m_uniforms);
+                const double* u = m_uniforms.data();
+                if(residual.total > 0.0)
+                {
+                    walk(m_residuals.data(), residual, n_rest, [u](size_t k) { return u[k]; },
+                        indices.data() + n_copies);
+                } else {
+                    // rounding left no residual mass
+                    walk(w, summary, n_rest, [u](size_t k) { return u[k]; },
+                        indices.data() + n_copies);
+                }
+            }
+            break;
+        }
+    }
+}
+
+void Resampler::resample(
+    const std::vector<double>& weights,
+    const size_t size,
+    std::vector<size_t>& indices)
+{
+    resample(engine(), weights, size, indices);
+}
+
+void Resampler::resample(
+    Engine& gen,
+    const std::vector<double>& weights,
+    geometry_msgs::PoseArray& particles)
+{
+    if(weights.size() != particles.poses.size())
+    {
+        throw std::runtime_error("resample: " + std::to_string(weights.size())
+            + " weights for " + std::to_string(particles.poses.size()) + " particles");
+    }
+
+    resample(gen, weights, weights.size(), m_indices);
+
+    m_poses.resize(m_indices.size());
+    for(size_t k=0; k<m_indices.size(); k++)
+    {
+        m_poses[k] = particles.poses[m_indices[k]];
+    }
+    // the previous poses become the buffer of the next call
+    particles.poses.swap(m_poses);
+}
+
+void Resampler::resample(
+    const std::vector<double>& weights,
+    geometry_msgs::PoseArray& particles)
+{
+    resample(engine(), weights, particles);
+}
+
+std::vector<size_t> resample(
+    Engine& gen,
+    const std::vector<double>& weights,
+    const size_t size,
+    const Resampling method)
+{
+    std::vector<size_t> indices;
+    Resampler(method).resample(gen, weights, size, indices);
+    return indices;
+}
+
+std::vector<size_t> resample(
+    const std::vector<double>& weights,
+    const size_t size,
+    const Resampling method)
+{
+    return resample(engine(), weights, size, method);
+}
+
+geometry_msgs::PoseArray resample(
+    Engine& gen,
+    const geometry_msgs::PoseArray& particles,
+    const std::vector<double>& weights,
+    const Resampling method)
+{
+    geometry_msgs::PoseArray ret = particles;
+    Resampler(method).resample(gen, weights, ret);
+    return ret;
+}
+
+geometry_msgs::PoseArray resample(
+    const geometry_msgs::PoseArray& particles,
+    const std::vector<double>& weights,
+    const Resampling method)
+{
+    return resample(engine(), particles, weights, method);
+}
+
+} // namespace random
+
+} // namespace rosmath
@@ -0,0 +1,217 @@
+#include "rosmath/sensor_msgs/random.h"
+#include "rosmath/sensor_msgs/misc.h"
+
+#include <Eigen/Dense>
+#include <limits>
+
+namespace rosmath {
+
+namespace random {
+
+namespace {
+
+// parallelize the synthesis of larger messages
+constexpr size_t PARALLEL_MIN_POINTS = 4096;
+
+} // namespace
+
+void laser_scan_fill(
+    const Philox& gen,
+    sensor_msgs::LaserScan& scan,
+    const LaserScanParams& params,
+    const size_t offset)
+{
+    const size_t n = params.beams;
+
+    scan.angle_min = params.angle_min;
+    scan.angle_max = params.angle_max;
+    scan.angle_increment = (n > 1) ? (params.angle_max - params.angle_min) / (n - 1) : 0.0;
+    scan.scan_time = params.scan_time;
+    scan.time_increment = (n > 0) ? params.scan_time / n : 0.0;
+    scan.range_min = params.range_min;
+    scan.range_max = params.range_max;
+    scan.ranges.resize(n);
+    scan.intensities.resize(params.intensities ? n : 0);
+
+    // uniforms [offset, offset + n), normals [offset + n, offset + 3n)
+    std::vector<double> r(3 * n);
+    uniform_fill(gen, r.data(), n, 0.0, 1.0, offset);
+    normal_fill(gen, r.data() + n, 2 * n, 0.0, 1.0, offset + n);
+    const double* u = r.data();
+    const double* z = r.data() + n;
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double x_max = 0.5 * params.room_x - params.x;
+    const double x_min = -0.5 * params.room_x - params.x;
+    const double y_max = 0.5 * params.room_y - params.y;
+    const double y_min = -0.5 * params.room_y - params.y;
+    const double angle_min = params.yaw + scan.angle_min;
+    const double angle_increment = scan.angle_increment;
+    float* ranges = scan.ranges.data();
+    float* intensities = scan.intensities.data();
+
+    #pragma omp parallel for if(n >= PARALLEL_MIN_POINTS)
+    for(size_t i=0; i<n; i++)
+    {
+        const double angle = angle_min + i * angle_increment;
+        const double c = cos(angle);
+        const double s = sin(angle);
+
+        // first wall hit by the beam
+        const double tx = (c > 0.0) ? x_max / c : (c < 0.0) ? x_min / c : inf;
+        const double ty = (s > 0.0) ? y_max / s : (s < 0.0) ? y_min / s : inf;
+        double range = std::min(tx, ty) + params.range_sigma * z[i];
+
+        if(u[i] < params.dropout || range > params.range_max)
+        {
+            range = inf;
+        } else if(range < params.range_min) {
+            range = -inf;
+        }
+        ranges[i] = range;
+
+        if(intensities)
+        {
+            const double intensity = params.intensity_scale / (1.0 + std::fabs(range))
+                + params.intensity_sigma * z[n + i];
+            intensities[i] = std::isfinite(range) ? std::max(intensity, 0.0) : 0.0;
+        }
+    }
+}
+
+void laser_scan_fill(
+    sensor_msgs::LaserScan& scan,
+    const LaserScanParams& params)
+{
+    laser_scan_fill(thread_philox(), scan, params);
+}
+
+sensor_msgs::LaserScan laser_scan(
+    const Philox& gen,
+    const LaserScanParams& params,
+    const size_t offset)
+{
+    sensor_msgs::LaserScan scan;
+    laser_scan_fill(gen, scan, params, offset);
+    return scan;
+}
+
+sensor_msgs::LaserScan laser_scan(
+    const LaserScanParams& params)
+{
+    return laser_scan(thread_philox(), params);
+}
+
+void point_cloud_fill(
+    const Philox& gen,
+    sensor_msgs::PointCloud& pcl,
+    const PointCloudParams& params,
+    const size_t offset)
+{
+    const size_t n = params.points;
+
+    pcl.points.resize(n);
+    if(params.normals)
+    {
+        pcl.channels.resize(3);
+        pcl.channels[0].name = POINTCLOUD_NORMAL_X;
+        pcl.channels[1].name = POINTCLOUD_NORMAL_Y;
+        pcl.channels[2].name = POINTCLOUD_NORMAL_Z;
+        for(auto& channel : pcl.channels)
+        {
+            channel.values.resize(n);
+        }
+    } else {
+        pcl.channels.clear();
+    }
+
+    // uniforms [offset, offset + 3n), normals [offset + 3n, offset + 6n)
+    std::vector<double> r(6 * n);
+    uniform_fill(gen, r.data(), 3 * n, 0.0, 1.0, offset);
+    normal_fill(gen, r.data() + 3 * n, 3 * n, 0.0, 1.0, offset + 3 * n);
+
+    const Eigen::Map<const Eigen::Matrix3Xd> U(r.data(), 3, n);
+    const Eigen::Map<const Eigen::Matrix3Xd> Z(r.data() + 3 * n, 3, n);
+
+    const Eigen::Matrix3d R = Eigen::Quaterniond(
+        params.pose.orientation.w, params.pose.orientation.x,
+        params.pose.orientation.y, params.pose.orientation.z).normalized().toRotationMatrix();
+    const Eigen::Vector3d t(params.pose.position.x, params.pose.position.y, params.pose.position.z);
+    const double half = 0.5 * params.size;
+
+    #pragma omp parallel for if(n >= PARALLEL_MIN_POINTS)
+    for(size_t j=0; j<n; j++)
+    {
+        const Eigen::Vector3d u = U.col(j);
+        Eigen::Vector3d p, normal;
+
+        switch(params.surface)
+        {
+            case Surface::PLANE: {
+                p << (2.0 * u(0) - 1.0) * half, (2.0 * u(1) - 1.0) * half, 0.0;
+                normal = Eigen::Vector3d::UnitZ();
+                break;
+            }
+            case Surface::SPHERE: {
+                const double cz = 2.0 * u(0) - 1.0;
+                const double rho = std::sqrt(std::max(1.0 - cz * cz, 0.0));
+                const double phi = 2.0 * M_PI * u(1);
+                normal << rho * cos(phi), rho * sin(phi), cz;
+                p = half * normal;
+                break;
+            }
+            case Surface::BOX: {
+                // faces have equal area
+                const int face = std::min(static_cast<int>(6.0 * u(2)), 5);
+                const int axis = face / 2;
+                const double sign = (face % 2) ? -1.0 : 1.0;
+                p(axis) = sign * half;
+                p((axis + 1) % 3) = (2.0 * u(0) - 1.0) * half;
+                p((axis + 2) % 3) = (2.0 * u(1) - 1.0) * half;
+                normal.setZero();
+                normal(axis) = sign;
+                break;
+            }
+        }
+
+        p = R * (p + params.sigma * Z.col(j)) + t;
+        pcl.points[j].x = p.x();
+        pcl.points[j].y = p.y();
+        pcl.points[j].z = p.z();
+
+        if(params.normals)
+        {
+            normal = R * normal;
+            pcl.channels[0].values[j] = normal.x();
+            pcl.channels[1].values[j] = normal.y();
+            pcl.channels[2].values[j] = normal.z();
+        }
+    }
+}
+
+void point_cloud_fill(
+    sensor_msgs::PointCloud& pcl,
+    const PointCloudParams& params)
+{
+    point_cloud_fill(thread_philox(), pcl, params);
+}
+
+sensor_msgs::PointCloud point_cloud(
+    const Philox& gen,
+    const PointCloudParams& params,
+    const size_t offset)
+{
+    sensor_msgs::PointCloud pcl;
+    point_cloud_fill(gen, pcl, params, offset);
+    return pcl;
+}
+
+sensor_msgs::PointCloud point_cloud(
+    const PointCloudParams& params)
+{
+    return point_cloud(thread_philox(), params);
+}
+
+} // namespace random
+
+} // namespace rosmath
@@ -0,0 +1,442 @@
+#include "rosmath/sensor_msgs/sampling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace rosmath {
+
+namespace random {
+
+namespace {
+
+// points per parallel chunk
+constexpr size_t CHUNK_SIZE = 1 << 16;
+
+// voxel coordinates are packed into 21 bits each
+constexpr int64_t CELL_BITS = 21;
+constexpr int64_t CELL_MASK = (int64_t(1) << CELL_BITS) - 1;
+
+/**
+ * adopts the header and channel names of cloud into the empty samples,
+ * otherwise checks that cloud has the same channels
+ */
+void prepare(sensor_msgs::PointCloud& samples, const sensor_msgs::PointCloud& cloud,
+    const size_t begin, const size_t end)
+{
+    if(begin > end || end > cloud.points.size())
+    {
+        throw std::runtime_error("sampling: range [" + std::to_string(begin) + ", "
+            + std::to_string(end) + ") exceeds " + std::to_string(cloud.points.size()) + " points");
+    }
+
+    for(const sensor_msgs::ChannelFloat32& channel : cloud.channels)
+    {
+        if(channel.values.size() != cloud.points.size())
+        {
+            throw std::runtime_error("sampling: channel '" + channel.name + "' has "
+                + std::to_string(channel.values.size()) + " values for "
+                + std::to_string(cloud.points.size()) + " points");
+        }
+    }
+
+    if(samples.points.empty() && samples.channels.empty())
+    {
+        samples.header = cloud.header;
+        samples.channels.resize(cloud.channels.size());
+        for(size_t c=0; c<cloud.channels.size(); c++)
+        {
+            samples.channels[c].name = cloud.channels[c].name;
+        }
+        return;
+    }
+
+    bool same = (samples.channels.size() == cloud.channels.size());
+    for(size_t c=0; same && c<cloud.channels.size(); c++)
+    {
+        same = (samples.channels[c].name == cloud.channels[c].name);
+    }
+    if(!same)
+    {
+        throw std::runtime_error("sampling: chunks have different channels");
+    }
+}
+
+// samples.points[slot] = cloud.points[i] and the same for all channels
+void assign(sensor_msgs::PointCloud& samples, const size_t slot,
+    const sensor_msgs::PointCloud& cloud, const size_t i)
+{
+    samples.points[slot] = cloud.points[i];
+    for(size_t c=0; c<samples.channels.size(); c++)
+    {
+        samples.channels[c].values[slot] = cloud.channels[c].values[i];
+    }
+}
+
+size_t append(sensor_msgs::PointCloud& samples,
+    const sensor_msgs::PointCloud& cloud, const size_t i)
+{
+    samples.points.push_back(cloud.points[i]);
+    for(size_t c=0; c<samples.channels.size(); c++)
+    {
+        samples.channels[c].values.push_back(cloud.channels[c].values[i]);
+    }
+    return samples.points.size() - 1;
+}
+
+// uniform in (0, 1]
+double uniform_open(Engine& gen)
+{
+    return 1.0 - std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+}
+
+template<typename Sampler, typename Param>
+sensor_msgs::PointCloud sample_parallel(
+    Engine& gen,
+    const sensor_msgs::PointCloud& cloud,
+    const Param param)
+{
+    const size_t n_chunks = std::max<size_t>(1, (cloud.points.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    std::vector<uint64_t> seeds(n_chunks);
+    for(size_t k=0; k<n_chunks; k++)
+    {
+        seeds[k] = gen();
+    }
+
+    std::vector<Sampler> samplers;
+    samplers.reserve(n_chunks);
+    for(size_t k=0; k<n_chunks; k++)
+    {
+        samplers.emplace_back(param, seeds[k]);
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(int64_t k=0; k<static_cast<int64_t>(n_chunks); k++)
+    {
+        const size_t begin = k * CHUNK_SIZE;
+        const size_t end = std::min(cloud.points.size(), begin + CHUNK_SIZE);
+        samplers[k].add(cloud, begin, end);
+    }
+
+    // pairwise tree reduction, in chunk order
+    for(size_t step=1; step<n_chunks; step*=2)
+    {
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(int64_t k=0; k<static_cast<int64_t>(n_chunks - step); k+=2*step)
+        {
+            samplers[k].merge(samplers[k + step]);
+        }
+    }
+
+    return samplers[0].cloud();
+}
+
+} // namespace
+
+// Reservoir
+
+ReservoirSampler::ReservoirSampler(const size_t capacity, const uint64_t seed)
+:m_capacity(capacity)
+,m_seen(0)
+,m_skip(0)
+,m_gen(seed)
+{
+
+}
+
+void ReservoirSampler::add(const sensor_msgs::PointCloud& cloud, const size_t begin, const size_t end)
+{
+    prepare(m_samples, cloud, begin, end);
+    m_seen += end - begin;
+
+    if(m_capacity == 0)
+    {
+        return;
+    }
+
+    const auto less = [this](size_t a, size_t b) { return m_keys[a] < m_keys[b]; };
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    size_t i = begin;
+
+    // fill
+    for(; i < end && m_samples.points.size() < m_capacity; i++)
+    {
+        const size_t slot = append(m_samples, cloud, i);
+        m_keys.push_back(uniform(m_gen));
+        m_heap.push_back(slot);
+        std::push_heap(m_heap.begin(), m_heap.end(), less);
+
+        if(m_samples.points.size() == m_capacity)
+        {
+            drawSkip();
+        }
+    }
+
+    // jump to the points that enter the reservoir
+    while(i < end)
+    {
+        if(m_skip >= end - i)
+        {
+            m_skip -= end - i;
+            break;
+        }
+        i += m_skip;
+
+        // key of the entering point is uniform below the largest key
+        const size_t slot = m_heap.front();
+        assign(m_samples, slot, cloud, i);
+        replace(slot, uniform(m_gen) * m_keys[slot]);
+        drawSkip();
+        i++;
+    }
+}
+
+void ReservoirSampler::add(const sensor_msgs::PointCloud& cloud)
+{
+    add(cloud, 0, cloud.points.size());
+}
+
+void ReservoirSampler::merge(const ReservoirSampler& other)
+{
+    if(other.m_capacity != m_capacity)
+    {
+        throw std::runtime_error("ReservoirSampler: cannot merge capacities "
+            + std::to_string(m_capacity) + " and " + std::to_string(other.m_capacity));
+    }
+
+    if(other.m_seen == 0)
+    {
+        return;
+    }
+
+    prepare(m_samples, other.m_samples, 0, other.m_samples.points.size());
+    m_seen += other.m_seen;
+
+    const auto less = [this](size_t a, size_t b) { return m_keys[a] < m_keys[b]; };
+
+    // keep the smallest keys of both. keys are independent uniforms, so the
+    // result is a uniform sample of the union
+    for(size_t j=0; j<other.m_samples.points.size(); j++)
+    {
+        const double key = other.m_keys[j];
+        if(m_samples.points.size() < m_capacity)
+        {
+            const size_t slot = append(m_samples, other.m_samples, j);
+            m_keys.push_back(key);
+            m_heap.push_back(slot);
+            std::push_heap(m_heap.begin(), m_heap.end(), less);
+        } else if(key < m_keys[m_heap.front()]) {
+            const size_t slot = m_heap.front();
+            assign(m_samples, slot, other.m_samples, j);
+            replace(slot, key);
+        }
+    }
+
+    // skips are memoryless, redraw for the new largest key
+    if(m_samples.points.size() == m_capacity)
+    {
+        drawSkip();
+    }
+}
+
+size_t ReservoirSampler::capacity() const
+{
+    return m_capacity;
+}
+
+size_t ReservoirSampler::seen() const
+{
+    return m_seen;
+}
+
+size_t ReservoirSampler::size() const
+{
+    return m_samples.points.size();
+}
+
+const sensor_msgs::PointCloud& ReservoirSampler::cloud() const
+{
+    return m_samples;
+}
+
+void ReservoirSampler::clear()
+{
+    m_seen = 0;
+    m_skip = 0;
+    m_samples = sensor_msgs::PointCloud();
+    m_keys.clear();
+    m_heap.clear();
+}
+
+void ReservoirSampler::replace(const size_t slot, const double key)
+{
+    const auto less = [this](size_t a, size_t b) { return m_keys[a] < m_keys[b]; };
+
+    // slot is the top of the heap
+    std::pop_heap(m_heap.begin(), m_heap.end(), less);
+    m_keys[slot] = key;
+    m_heap.back() = slot;
+    std::push_heap(m_heap.begin(), m_heap.end(), less);
+}
+
+void ReservoirSampler::drawSkip()
+{
+    // a point enters with probability t (the largest key): the number of
+    // points before the next one is geometric
+    const double t = m_keys[m_heap.front()];
+    const double skip = std::floor(std::log(uniform_open(m_gen)) / std::log1p(-t));
+    m_skip = (skip < static_cast<double>(std::numeric_limits<size_t>::max()))
+        ? static_cast<size_t>(skip)
+        : std::numeric_limits<size_t>::max();
+}
+
+// Stratified
+
+StratifiedSampler::StratifiedSampler(const double cell_size, const uint64_t seed)
+:m_cell_size(cell_size)
+,m_seen(0)
+,m_gen(seed)
+{
+    if(!(cell_size > 0.0))
+    {
+        throw std::runtime_error("StratifiedSampler: cell size must be positive");
+    }
+}
+
+void StratifiedSampler::add(const sensor_msgs::PointCloud& cloud, const size_t begin, const size_t end)
+{
+    prepare(m_samples, cloud, begin, end);
+    m_seen += end - begin;
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    for(size_t i=begin; i<end; i++)
+    {
+        Cell& cell = m_cells[key(cloud.points[i])];
+        if(cell.count == 0)
+        {
+            cell.slot = append(m_samples, cloud, i);
+        } else if(uniform(m_gen) * (cell.count + 1) < 1.0) {
+            assign(m_samples, cell.slot, cloud, i);
+        }
+        cell.count++;
+    }
+}
+
+void StratifiedSampler::add(const sensor_msgs::PointCloud& cloud)
+{
+    add(cloud, 0, cloud.points.size());
+}
+
+void StratifiedSampler::merge(const StratifiedSampler& other)
+{
+    if(other.m_cell_size != m_cell_size)
+    {
+        throw std::runtime_error("StratifiedSampler: cannot merge different cell sizes");
+    }
+
+    if(other.m_seen == 0)
+    {
+        return;
+    }
+
+    prepare(m_samples, other.m_samples, 0, other.m_samples.points.size());
+    m_seen += other.m_seen;
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // iterate in slot order of other to keep the order of first appearance
+    std::vector<const std::pair<const int64_t, Cell>*> cells(other.m_cells.size());
+    for(const auto& entry : other.m_cells)
+    {
+        cells[entry.second.slot] = &entry;
+    }
+
+    for(const auto* entry : cells)
+    {
+        const Cell& theirs = entry->second;
+        Cell& cell = m_cells[entry->first];
+        if(cell.count == 0)
+        {
+            cell.slot = append(m_samples, other.m_samples, theirs.slot);
+        } else if(uniform(m_gen) * (cell.count + theirs.count) < theirs.count) {
+            assign(m_samples, cell.slot, other.m_samples, theirs.slot);
+        }
+        cell.count += theirs.count;
+    }
+}
+
+double StratifiedSampler::cellSize() const
+{
+    return m_cell_size;
+}
+
+size_t StratifiedSampler::seen() const
+{
+    return m_seen;
+}
+
+size_t StratifiedSampler::size() const
+{
+    return m_samples.points.size();
+}
+
+const sensor_msgs::PointCloud& StratifiedSampler::cloud() const
+{
+    return m_samples;
+}
+
+void StratifiedSampler::clear()
+{
+    m_seen = 0;
+    m_samples = sensor_msgs::PointCloud();
+    m_cells.clear();
+}
+
+int64_t StratifiedSampler::key(const geometry_msgs::Point32& p) const
+{
+    const int64_t ix = static_cast<int64_t>(std::floor(p.x / m_cell_size));
+    const int64_t iy = static_cast<int64_t>(std::floor(p.y / m_cell_size));
+    const int64_t iz = static_cast<int64_t>(std::floor(p.z / m_cell_size));
+    return ((ix & CELL_MASK) << (2 * CELL_BITS)) | ((iy & CELL_MASK) << CELL_BITS) | (iz & CELL_MASK);
+}
+
+// whole clouds
+
+sensor_msgs::PointCloud reservoir_sample(
+    Engine& gen,
+    const sensor_msgs::PointCloud& cloud,
+    const size_t size)
+{
+    return sample_parallel<ReservoirSampler>(gen, cloud, size);
+}
+
+sensor_msgs::PointCloud reservoir_sample(
+    const sensor_msgs::PointCloud& cloud,
+    const size_t size)
+{
+    return reservoir_sample(engine(), cloud, size);
+}
+
+sensor_msgs::PointCloud stratified_sample(
+    Engine& gen,
+    const sensor_msgs::PointCloud& cloud,
+    const double cell_size)
+{
+    return sample_parallel<StratifiedSampler>(gen, cloud, cell_size);
+}
+
+sensor_msgs::PointCloud stratified_sample(
+    const sensor_msgs::PointCloud& cloud,
+    const double cell_size)
+{
+    return stratified_sample(engine(), cloud, cell_size);
+}
+
+} // namespace random
+
+} // namespace rosmath
@@ -1,4 +1,7 @@
 #include "rosmath/stats.h"
+#include "rosmath/eigen/map.h"
+#include <algorithm>
+#include <limits>
 
 namespace rosmath {
 
@@ -66,7 +69,7 @@ Eigen::Matrix3d covariance(
     const std::vector<geometry_msgs::Point>& points,
     const geometry_msgs::Point mean)
 {
-    Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> > mat(&points[0].x, points.size(), 3);
+    const ConstPointsMap mat = eigen_map(points);
     Eigen::Matrix<double,1,3> eig_mean;
     eig_mean(0,0) = mean.x;
     eig_mean(0,1) = mean.y;
@@ -81,25 +84,780 @@ Eigen::Matrix3d covariance(
     return covariance(points, mean(points));
 }
 
-void pca(
-    const std::vector<geometry_msgs::Point>& points)
+PCA pca(
+    const Eigen::Matrix3d& cov)
 {
     Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> es;
+    es.computeDirect(cov);
+
+    PCA ret;
+    ret.eigenvalues = es.eigenvalues();
+    ret.eigenvectors = es.eigenvectors();
+    return ret;
+}
+
+PCA pca(
+    const std::vector<geometry_msgs::Point>& points)
+{
+    return pca(covariance(points));
+}
 
-    auto cov = covariance(points);
-    std::cout << "compute eigen value and vectors of " << std::endl;
-    std::cout << cov << std::endl;
+void pca(
+    const std::vector<geometry_msgs::Point>& points,
+    const std::vector<std::vector<size_t> >& neighborhoods,
+    std::vector<PCA>& result)
+{
+    result.resize(neighborhoods.size());
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for(size_t i=0; i<neighborhoods.size(); i++)
+    {
+        const std::vector<size_t>& ids = neighborhoods[i];
+        
+        if(ids.size() < 3)
+        {
+            result[i].eigenvalues.setZero();
+            result[i].eigenvectors.setIdentity();
+            continue;
+        }
+
+        // two passes over the neighborhood without temporary copies
+        Eigen::Vector3d m = Eigen::Vector3d::Zero();
+        for(const size_t id : ids)
+        {
+            const geometry_msgs::Point& p = points[id];
+            m += Eigen::Vector3d(p.x, p.y, p.z);
+        }
+        m /= static_cast<double>(ids.size());
+
+        Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+        for(const size_t id : ids)
+        {
+            const geometry_msgs::Point& p = points[id];
+            const Eigen::Vector3d d = Eigen::Vector3d(p.x, p.y, p.z) - m;
+            cov.selfadjointView<Eigen::Lower>().rankUpdate(d);
+        }
+        cov = cov.selfadjointView<Eigen::Lower>();
+        cov /= static_cast<double>(ids.size() - 1);
+
+        result[i] = pca(cov);
+    }
+}
 
-    es.compute(cov);
+std::vector<PCA> pca(
+    const std::vector<geometry_msgs::Point>& points,
+    const std::vector<std::vector<size_t> >& neighborhoods)
+{
+    std::vector<PCA> ret;
+    pca(points, neighborhoods, ret);
+    return ret;
+}
+
+double linearity(const PCA& pca)
+{
+    const Eigen::Vector3d& l = pca.eigenvalues;
+    return l(2) > 0.0 ? (l(2) - l(1)) / l(2) : 0.0;
+}
+
+double planarity(const PCA& pca)
+{
+    const Eigen::Vector3d& l = pca.eigenvalues;
+    return l(2) > 0.0 ? (l(1) - l(0)) / l(2) : 0.0;
+}
+
+double scattering(const PCA& pca)
+{
+    const Eigen::Vector3d& l = pca.eigenvalues;
+    return l(2) > 0.0 ? l(0) / l(2) : 0.0;
+}
+
+namespace {
+
+// quantile of the values in buffer, reorders buffer
+double select_quantile(
+    std::vector<double>& buffer,
+    const double q)
+{
+    if(buffer.empty())
+    {
+        throw std::runtime_error("Cannot compute quantile of empty data");
+    }
 
-    std::cout << "Principal Components:" << std::endl;
+    const double h = std::min(std::max(q, 0.0), 1.0) * (buffer.size() - 1);
+    const size_t lo = static_cast<size_t>(h);
     
-    std::cout << "-- " << es.eigenvectors().col(2).transpose() 
-                       << ": " << es.eigenvalues()(2) << std::endl;
-    std::cout << "-- " << es.eigenvectors().col(1).transpose() 
-                       << ": " << es.eigenvalues()(1) << std::endl;
-    std::cout << "-- " << es.eigenvectors().col(0).transpose() 
-                       << ": " << es.eigenvalues()(0) << std::endl;
+    auto it_lo = buffer.begin() + lo;
+    std::nth_element(buffer.begin(), it_lo, buffer.end());
+    const double v_lo = *it_lo;
+
+    if(lo + 1 >= buffer.size())
+    {
+        return v_lo;
+    }
+
+    // next order statistic is the minimum of the upper partition
+    const double v_hi = *std::min_element(it_lo + 1, buffer.end());
+    return v_lo + (h - lo) * (v_hi - v_lo);
+}
+
+// median of |buffer_i - median|, overwrites buffer
+double select_mad(
+    std::vector<double>& buffer,
+    const double median)
+{
+    if(buffer.empty())
+    {
+        throw std::runtime_error("Cannot compute MAD of empty data");
+    }
+
+    for(double& v : buffer)
+    {
+        v = std::fabs(v - median);
+    }
+
+    auto it_mid = buffer.begin() + (buffer.size() - 1) / 2;
+    std::nth_element(buffer.begin(), it_mid, buffer.end());
+    const double v_lo = *it_mid;
+
+    if(buffer.size() % 2 == 1)
+    {
+        return v_lo;
+    }
+
+    return 0.5 * (v_lo + *std::min_element(it_mid + 1, buffer.end()));
+}
+
+// copies one coordinate of the points into buffer
+void select_coordinate(
+    const std::vector<geometry_msgs::Point>& points,
+    double geometry_msgs::Point::* coordinate,
+    std::vector<double>& buffer)
+{
+    buffer.resize(points.size());
+    for(size_t i=0; i<points.size(); i++)
+    {
+        buffer[i] = points[i].*coordinate;
+    }
+}
+
+} // namespace
+
+double quantile(
+    const std::vector<double>& data,
+    const double q,
+    std::vector<double>& buffer)
+{
+    if(&buffer != &data)
+    {
+        buffer.assign(data.begin(), data.end());
+    }
+    return select_quantile(buffer, q);
+}
+
+double quantile(
+    const std::vector<double>& data,
+    const double q)
+{
+    std::vector<double> buffer;
+    return quantile(data, q, buffer);
+}
+
+double median(
+    const std::vector<double>& data,
+    std::vector<double>& buffer)
+{
+    return quantile(data, 0.5, buffer);
+}
+
+double median(
+    const std::vector<double>& data)
+{
+    std::vector<double> buffer;
+    return median(data, buffer);
 }
 
+double mad(
+    const std::vector<double>& data,
+    const double median,
+    std::vector<double>& buffer)
+{
+    if(&buffer != &data)
+    {
+        buffer.assign(data.begin(), data.end());
+    }
+    return select_mad(buffer, median);
+}
+
+double mad(
+    const std::vector<double>& data,
+    std::vector<double>& buffer)
+{
+    return mad(data, median(data, buffer), buffer);
+}
+
+double mad(
+    const std::vector<double>& data)
+{
+    std::vector<double> buffer;
+    return mad(data, buffer);
+}
+
+geometry_msgs::Point quantile(
+    const std::vector<geometry_msgs::Point>& points,
+    const double q,
+    std::vector<double>& buffer)
+{
+    geometry_msgs::Point ret;
+
+    select_coordinate(points, &geometry_msgs::Point::x, buffer);
+    ret.x = select_quantile(buffer, q);
+    select_coordinate(points, &geometry_msgs::Point::y, buffer);
+    ret.y = select_quantile(buffer, q);
+    select_coordinate(points, &geometry_msgs::Point::z, buffer);
+    ret.z = select_quantile(buffer, q);
+
+    return ret;
+}
+
+geometry_msgs::Point quantile(
+    const std::vector<geometry_msgs::Point>& points,
+    const double q)
+{
+    std::vector<double> buffer;
+    return quantile(points, q, buffer);
+}
+
+geometry_msgs::Point median(
+    const std::vector<geometry_msgs::Point>& points,
+    std::vector<double>& buffer)
+{
+    return quantile(points, 0.5, buffer);
+}
+
+geometry_msgs::Point median(
+    const std::vector<geometry_msgs::Point>& points)
+{
+    std::vector<double> buffer;
+    return median(points, buffer);
+}
+
+geometry_msgs::Point mad(
+    const std::vector<geometry_msgs::Point>& points,
+    const geometry_msgs::Point median,
+    std::vector<double>& buffer)
+{
+    geometry_msgs::Point ret;
+
+    select_coordinate(points, &geometry_msgs::Point::x, buffer);
+    ret.x = select_mad(buffer, median.x);
+    select_coordinate(points, &geometry_msgs::Point::y, buffer);
+    ret.y = select_mad(buffer, median.y);
+    select_coordinate(points, &geometry_msgs::Point::z, buffer);
+    ret.z = select_mad(buffer, median.z);
+
+    return ret;
+}
+
+geometry_msgs::Point mad(
+    const std::vector<geometry_msgs::Point>& points)
+{
+    std::vector<double> buffer;
+    return mad(points, median(points, buffer), buffer);
+}
+
+geometry_msgs::Point quantile(
+    const PointQuantiles& sketch,
+    const double q)
+{
+    geometry_msgs::Point ret;
+    ret.x = sketch.quantiles[0].quantile(q);
+    ret.y = sketch.quantiles[1].quantile(q);
+    ret.z = sketch.quantiles[2].quantile(q);
+    return ret;
+}
+
+namespace stats {
+
+TDigest::TDigest(const double compression)
+:m_compression(compression)
+,m_min(std::numeric_limits<double>::infinity())
+,m_max(-std::numeric_limits<double>::infinity())
+,m_weight(0.0)
+{
+    m_centroids.reserve(2 * static_cast<size_t>(compression) + 1);
+    m_buffer.reserve(5 * static_cast<size_t>(compression));
+}
+
+void TDigest::add(const double x, const double w)
+{
+    if(std::isnan(x))
+    {
+        return;
+    }
+
+    m_buffer.push_back({x, w});
+    m_min = std::min(m_min, x);
+    m_max = std::max(m_max, x);
+
+    if(m_buffer.size() >= 5 * static_cast<size_t>(m_compression))
+    {
+        compress();
+    }
+}
+
+void TDigest::add(const std::vector<double>& data)
+{
+    for(const double x : data)
+    {
+        add(x);
+    }
+}
+
+void TDigest::merge(const TDigest& other)
+{
+    other.compress();
+    for(const Centroid& c : other.m_centroids)
+    {
+        m_buffer.push_back(c);
+    }
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    compress();
+}
+
+void TDigest::compress() const
+{
+    if(m_buffer.empty())
+    {
+        return;
+    }
+
+    m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+    std::sort(m_buffer.begin(), m_buffer.end(), 
+        [](const Centroid& a, const Centroid& b) {
+            return a.mean < b.mean;
+        });
+
+    double total = 0.0;
+    for(const Centroid& c : m_buffer)
+    {
+        total += c.weight;
+    }
+
+    // scale function k1: k(q) = delta / (2 pi) * asin(2q - 1)
+    const double norm = m_compression / (2.0 * M_PI);
+    auto k_to_q = [&](double k) {
+        if(k >= m_compression / 4.0)
+        {
+            return 1.0;
+        }
+        return 0.5 * (std::sin(k / norm) + 1.0);
+    };
+    auto q_to_k = [&](double q) {
+        return norm * std::asin(2.0 * q - 1.0);
+    };
+
+    m_centroids.clear();
+    Centroid cur = m_buffer[0];
+    double w_so_far = 0.0;
+    double w_limit = total * k_to_q(q_to_k(0.0) + 1.0);
+
+    for(size_t i=1; i<m_buffer.size(); i++)
+    {
+        const Centroid& next = m_buffer[i];
+        if(w_so_far + cur.weight + next.weight <= w_limit)
+        {
+            cur.weight += next.weight;
+            cur.mean += (next.mean - cur.mean) * next.weight / cur.weight;
+        } else {
+            w_so_far += cur.weight;
+            m_centroids.push_back(cur);
+            w_limit = total * k_to_q(q_to_k(w_so_far / total) + 1.0);
+            cur = next;
+        }
+    }
+    m_centroids.push_back(cur);
+
+    m_weight = total;
+    m_buffer.clear();
+}
+
+double TDigest::quantile(const double q) const
+{
+    compress();
+
+    if(m_centroids.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if(m_centroids.size() == 1 || q <= 0.0)
+    {
+        return q <= 0.0 ? m_min : (q >= 1.0 ? m_max : m_centroids[0].mean);
+    }
+    if(q >= 1.0)
+    {
+        return m_max;
+    }
+
+    const double index = q * m_weight;
+
+    // left tail: between min and the first centroid center
+    const Centroid& first = m_centroids.front();
+    if(index < first.weight / 2.0)
+    {
+        return m_min + (first.mean - m_min) * index / (first.weight / 2.0);
+    }
+
+    double w_so_far = first.weight / 2.0;
+    for(size_t i=0; i+1<m_centroids.size(); i++)
+    {
+        const Centroid& a = m_centroids[i];
+        const Centroid& b = m_centroids[i+1];
+        const double dw = (a.weight + b.weight) / 2.0;
+        if(w_so_far + dw > index)
+        {
+            const double t = (index - w_so_far) / dw;
+            return a.mean + t * (b.mean - a.mean);
+        }
+        w_so_far += dw;
+    }
+
+    // right tail: between the last centroid center and max
+    const Centroid& last = m_centroids.back();
+    const double t = (index - w_so_far) / (last.weight / 2.0);
+    return last.mean + std::min(t, 1.0) * (m_max - last.mean);
+}
+
+double TDigest::cdf(const double x) const
+{
+    compress();
+
+    if(m_centroids.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if(x < m_min)
+    {
+        return 0.0;
+    }
+    if(x >= m_max)
+    {
+        return 1.0;
+    }
+
+    const Centroid& first = m_centroids.front();
+    if(x < first.mean)
+    {
+        const double dx = first.mean - m_min;
+        return (dx > 0.0 ? (x - m_min) / dx : 1.0) * first.weight / 2.0 / m_weight;
+    }
+
+    double w_so_far = first.weight / 2.0;
+    for(size_t i=0; i+1<m_centroids.size(); i++)
+    {
+        const Centroid& a = m_centroids[i];
+        const Centroid& b = m_centroids[i+1];
+        const double dw = (a.weight + b.weight) / 2.0;
+        if(x < b.mean)
+        {
+            const double dx = b.mean - a.mean;
+            return (w_so_far + (dx > 0.0 ? (x - a.mean) / dx : 0.0) * dw) / m_weight;
+        }
+        w_so_far += dw;
+    }
+
+    const Centroid& last = m_centroids.back();
+    const double dx = m_max - last.mean;
+    return (w_so_far + (dx > 0.0 ? (x - last.mean) / dx : 1.0) * last.weight / 2.0) / m_weight;
+}
+
+double TDigest::median() const
+{
+    return quantile(0.5);
+}
+
+double TDigest::count() const
+{
+    compress();
+    return m_weight;
+}
+
+double TDigest::min() const
+{
+    return m_min;
+}
+
+double TDigest::max() const
+{
+    return m_max;
+}
+
+size_t TDigest::size() const
+{
+    compress();
+    return m_centroids.size();
+}
+
+void TDigest::clear()
+{
+    m_centroids.clear();
+    m_buffer.clear();
+    m_weight = 0.0;
+    m_min = std::numeric_limits<double>::infinity();
+    m_max = -std::numeric_limits<double>::infinity();
+}
+
+SlidingWindow::SlidingWindow(
+    const ros::Duration& duration,
+    const size_t max_size)
+:m_duration(duration)
+,m_max_size(max_size)
+,m_head(0)
+,m_size(0)
+{
+    if(m_max_size > 0)
+    {
+        m_samples.resize(m_max_size);
+    }
+    clear();
+}
+
+SlidingWindow::SlidingWindow(
+    const size_t max_size)
+:SlidingWindow(ros::Duration(0.0), max_size)
+{
+
+}
+
+void SlidingWindow::add(const ros::Time& stamp, const geometry_msgs::Point& p)
+{
+    push(stamp, Eigen::Vector3d(p.x, p.y, p.z), Eigen::Vector4d::Zero());
+}
+
+void SlidingWindow::add(const ros::Time& stamp, const geometry_msgs::Pose& p)
+{
+    const geometry_msgs::Quaternion& q = p.orientation;
+    push(stamp, 
+        Eigen::Vector3d(p.position.x, p.position.y, p.position.z), 
+        Eigen::Vector4d(q.x, q.y, q.z, q.w));
+}
+
+void SlidingWindow::add(const geometry_msgs::PointStamped& p)
+{
+    add(p.header.stamp, p.point);
+}
+
+void SlidingWindow::add(const geometry_msgs::PoseStamped& p)
+{
+    add(p.header.stamp, p.pose);
+}
+
+void SlidingWindow::push(
+    const ros::Time& stamp, 
+    const Eigen::Vector3d& p, 
+    const Eigen::Vector4d& q)
+{
+    evict(stamp);
+
+    if(m_max_size > 0 && m_size >= m_max_size)
+    {
+        pop();
+    }
+
+    if(m_size == m_samples.size())
+    {
+        // grow ring buffer: unroll into new storage
+        std::vector<Sample> samples(std::max<size_t>(16, 2 * m_samples.size()));
+        for(size_t i=0; i<m_size; i++)
+        {
+            samples[i] = at(i);
+        }
+        m_samples.swap(samples);
+        m_head = 0;
+    }
+
+    if(m_size == 0)
+    {
+        m_anchor = p;
+        m_q_anchor = q;
+        m_sum.setZero();
+        m_sum_sq.setZero();
+        m_q_sum.setZero();
+        m_updates = 0;
+    }
+
+    Sample& s = m_samples[(m_head + m_size) % m_samples.size()];
+    s.stamp = stamp;
+    s.p = p;
+    // q and -q are the same rotation: align to anchor
+    s.q = (q.dot(m_q_anchor) < 0.0) ? Eigen::Vector4d(-q) : q;
+    m_size++;
+
+    const Eigen::Vector3d d = p - m_anchor;
+    m_sum += d;
+    m_sum_sq += d * d.transpose();
+    m_q_sum += s.q;
+
+    m_updates++;
+    if(m_updates >= std::max<size_t>(m_size, 64))
+    {
+        reanchor();
+    }
+}
+
+void SlidingWindow::pop()
+{
+    const Sample& s = m_samples[m_head];
+
+    const Eigen::Vector3d d = s.p - m_anchor;
+    m_sum -= d;
+    m_sum_sq -= d * d.transpose();
+    m_q_sum -= s.q;
+
+    m_head = (m_head + 1) % m_samples.size();
+    m_size--;
+    m_updates++;
+}
+
+void SlidingWindow::evict(const ros::Time& stamp)
+{
+    if(m_duration.toSec() <= 0.0)
+    {
+        return;
+    }
+
+    const double tmin = stamp.toSec() - m_duration.toSec();
+    while(m_size > 0 && m_samples[m_head].stamp.toSec() < tmin)
+    {
+        pop();
+    }
+}
+
+void SlidingWindow::reanchor()
+{
+    if(m_size == 0)
+    {
+        return;
+    }
+
+    m_anchor += m_sum / static_cast<double>(m_size);
+    if(m_q_sum.squaredNorm() > 0.0)
+    {
+        m_q_anchor = m_q_sum.normalized();
+    }
+
+    m_sum.setZero();
+    m_sum_sq.setZero();
+    m_q_sum.setZero();
+
+    for(size_t i=0; i<m_size; i++)
+    {
+        Sample& s = m_samples[(m_head + i) % m_samples.size()];
+        const Eigen::Vector3d d = s.p - m_anchor;
+        m_sum += d;
+        m_sum_sq += d * d.transpose();
+        if(s.q.dot(m_q_anchor) < 0.0)
+        {
+            s.q = -s.q;
+        }
+        m_q_sum += s.q;
+    }
+
+    m_updates = 0;
+}
+
+const SlidingWindow::Sample& SlidingWindow::at(size_t i) const
+{
+    return m_samples[(m_head + i) % m_samples.size()];
+}
+
+size_t SlidingWindow::size() const
+{
+    return m_size;
+}
+
+bool SlidingWindow::empty() const
+{
+    return m_size == 0;
+}
+
+void SlidingWindow::clear()
+{
+    m_head = 0;
+    m_size = 0;
+    m_anchor.setZero();
+    m_sum.setZero();
+    m_sum_sq.setZero();
+    m_q_anchor = Eigen::Vector4d(0.0, 0.0, 0.0, 1.0);
+    m_q_sum.setZero();
+    m_updates = 0;
+}
+
+ros::Time SlidingWindow::oldest() const
+{
+    return m_size > 0 ? at(0).stamp : ros::Time();
+}
+
+ros::Time SlidingWindow::newest() const
+{
+    return m_size > 0 ? at(m_size - 1).stamp : ros::Time();
+}
+
+geometry_msgs::Point SlidingWindow::mean() const
+{
+    geometry_msgs::Point ret;
+    if(m_size == 0)
+    {
+        return ret;
+    }
+
+    const Eigen::Vector3d m = m_anchor + m_sum / static_cast<double>(m_size);
+    ret.x = m.x();
+    ret.y = m.y();
+    ret.z = m.z();
+    return ret;
+}
+
+geometry_msgs::Point SlidingWindow::variance() const
+{
+    const Eigen::Matrix3d cov = covariance();
+    geometry_msgs::Point ret;
+    ret.x = cov(0,0);
+    ret.y = cov(1,1);
+    ret.z = cov(2,2);
+    return ret;
+}
+
+Eigen::Matrix3d SlidingWindow::covariance() const
+{
+    if(m_size < 2)
+    {
+        return Eigen::Matrix3d::Zero();
+    }
+
+    const double n = static_cast<double>(m_size);
+    return (m_sum_sq - m_sum * m_sum.transpose() / n) / (n - 1.0);
+}
+
+geometry_msgs::Quaternion SlidingWindow::orientation() const
+{
+    geometry_msgs::Quaternion ret;
+    Eigen::Vector4d q = m_q_sum;
+    if(q.squaredNorm() == 0.0)
+    {
+        ret.w = 1.0;
+        return ret;
+    }
+    q.normalize();
+    ret.x = q(0);
+    ret.y = q(1);
+    ret.z = q(2);
+    ret.w = q(3);
+    return ret;
+}
+
+} // namespace stats
+
 } // namespace rosmath
\ No newline at end of file
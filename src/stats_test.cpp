@@ -0,0 +1,1085 @@
+#include <ros/ros.h>
+#include <rosmath/rosmath.h>
+#include <rosmath/stats.h>
+#include <rosmath/random.h>
+#include <rosmath/eigen/stats.h>
+#include <rosmath/eigen/gmm.h>
+#include <rosmath/eigen/kalman.h>
+#include <rosmath/eigen/ndt.h>
+#include <rosmath/eigen/ransac.h>
+#include <iostream>
+
+using namespace rosmath;
+
+bool testQuantiles()
+{
+    bool ret = true;
+
+    std::vector<double> data = {5.0, 1.0, 4.0, 2.0, 3.0};
+    std::vector<double> buffer;
+
+    if(median(data, buffer) != 3.0)
+    {
+        ROS_WARN_STREAM("error: median " << median(data, buffer));
+        ret = false;
+    }
+
+    if(quantile(data, 0.0, buffer) != 1.0 
+        || quantile(data, 1.0, buffer) != 5.0
+        || quantile(data, 0.125, buffer) != 1.5)
+    {
+        ROS_WARN_STREAM("error: quantile interpolation");
+        ret = false;
+    }
+
+    // |x - 3| = 2,2,1,1,0
+    if(mad(data, buffer) != 1.0)
+    {
+        ROS_WARN_STREAM("error: mad " << mad(data, buffer));
+        ret = false;
+    }
+
+    // robust against outliers
+    data.push_back(1000.0);
+    if(median(data) != 3.5)
+    {
+        ROS_WARN_STREAM("error: median with outlier " << median(data));
+        ret = false;
+    }
+
+    // per coordinate, the scratch buffer is reused
+    std::vector<geometry_msgs::Point> points(5);
+    for(size_t i=0; i<points.size(); i++)
+    {
+        points[i].x = data[i];
+        points[i].y = 2.0 * data[i];
+        points[i].z = -data[i];
+    }
+    const geometry_msgs::Point pm = median(points, buffer);
+    const double* scratch = buffer.data();
+    const geometry_msgs::Point pmad = mad(points, pm, buffer);
+    if(pm.x != 3.0 || pm.y != 6.0 || pm.z != -3.0 
+        || pmad.x != 1.0 || pmad.y != 2.0 || pmad.z != 1.0
+        || buffer.data() != scratch)
+    {
+        ROS_WARN_STREAM("error: point median / mad");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testTDigest()
+{
+    bool ret = true;
+
+    random::seed(42);
+    std::vector<double> data = random::uniform_numbers(0.0, 1.0, 100000);
+
+    // fill two digests independently, like two threads would do
+    stats::TDigest d1, d2;
+    for(size_t i=0; i<data.size(); i++)
+    {
+        if(i % 2 == 0)
+        {
+            d1.add(data[i]);
+        } else {
+            d2.add(data[i]);
+        }
+    }
+    d1.merge(d2);
+
+    if(d1.count() != data.size() || d1.size() > 200)
+    {
+        ROS_WARN_STREAM("error: tdigest size " << d1.count() << ", " << d1.size());
+        ret = false;
+    }
+
+    const std::vector<double> qs = {0.01, 0.1, 0.5, 0.9, 0.99};
+    for(const double q : qs)
+    {
+        double exact = quantile(data, q);
+        double approx = d1.quantile(q);
+        if(std::fabs(exact - approx) > 0.01)
+        {
+            ROS_WARN_STREAM("error: tdigest quantile " << q << ": " << approx << " != " << exact);
+            ret = false;
+        }
+
+        if(std::fabs(d1.cdf(exact) - q) > 0.01)
+        {
+            ROS_WARN_STREAM("error: tdigest cdf " << q << ": " << d1.cdf(exact));
+            ret = false;
+        }
+    }
+
+    return ret;
+}
+
+bool testPointStats()
+{
+    bool ret = true;
+
+    geometry_msgs::Point mu, sigma;
+    mu.x = 1.0;
+    mu.y = -2.0;
+    sigma.x = 1.0;
+    sigma.y = 0.5;
+    sigma.z = 2.0;
+
+    std::vector<geometry_msgs::Point> points = random::normal_points(mu, sigma, 10000);
+
+    auto st = calculate_stats<PointMedian, PointMAD, PointQuantiles>(points);
+
+    geometry_msgs::Point sigma_est = st.mad * stats::MAD_TO_SIGMA;
+    if(norm(st.median - mu) > 0.1 || norm(sigma_est - sigma) > 0.1)
+    {
+        ROS_WARN_STREAM("error: robust stats\n" << st.median << "\n" << sigma_est);
+        ret = false;
+    }
+
+    if(norm(quantile(st, 0.5) - st.median) > 0.05)
+    {
+        ROS_WARN_STREAM("error: sketch median\n" << quantile(st, 0.5));
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testSlidingWindow()
+{
+    bool ret = true;
+
+    // 2 seconds at 100 Hz, far from the origin to stress the sums
+    stats::SlidingWindow window(ros::Duration(2.0));
+    std::vector<geometry_msgs::Point> history;
+
+    geometry_msgs::Point offset, sigma;
+    offset.x = 1.0e6;
+    offset.y = -5.0e5;
+    sigma.x = 0.1;
+    sigma.y = 0.2;
+    sigma.z = 0.3;
+
+    for(size_t i=0; i<5000; i++)
+    {
+        geometry_msgs::PointStamped p;
+        p.header.stamp = ros::Time(1000.0 + i * 0.01);
+        p.point = random::normal_point(offset, sigma);
+        window.add(p);
+        history.push_back(p.point);
+    }
+
+    // window holds stamps in [t - 2s, t]
+    std::vector<geometry_msgs::Point> last(history.end() - window.size(), history.end());
+    if(window.size() < 200 || window.size() > 201)
+    {
+        ROS_WARN_STREAM("error: window size " << window.size());
+        ret = false;
+    }
+
+    if(norm(window.mean() - mean(last)) > 1e-6)
+    {
+        ROS_WARN_STREAM("error: window mean\n" << window.mean() << "\n" << mean(last));
+        ret = false;
+    }
+
+    if((window.covariance() - covariance(last)).norm() > 1e-6)
+    {
+        ROS_WARN_STREAM("error: window covariance\n" << window.covariance() << "\n" << covariance(last));
+        ret = false;
+    }
+
+    // count window
+    stats::SlidingWindow counted(10);
+    for(size_t i=0; i<25; i++)
+    {
+        geometry_msgs::Pose pose;
+        pose.position.x = i;
+        pose.orientation = rpy2quat(0.0, 0.0, 0.1);
+        counted.add(ros::Time(1.0 + i), pose);
+    }
+
+    if(counted.size() != 10 || counted.mean().x != 19.5 
+        || std::fabs(quat2rpy(counted.orientation()).z - 0.1) > 1e-9)
+    {
+        ROS_WARN_STREAM("error: count window " << counted.size() << ", " << counted.mean().x);
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testPCA()
+{
+    bool ret = true;
+
+    // noisy plane z = 0
+    geometry_msgs::Point pmin, pmax;
+    pmin.x = -1.0;
+    pmin.y = -2.0;
+    pmin.z = -0.001;
+    pmax.x = 1.0;
+    pmax.y = 2.0;
+    pmax.z = 0.001;
+    std::vector<geometry_msgs::Point> points = random::uniform_points(pmin, pmax, 1000);
+
+    PCA pc = pca(points);
+    if(std::fabs(std::fabs(pc.eigenvectors(2,0)) - 1.0) > 1e-3 
+        || std::fabs(std::fabs(pc.eigenvectors(1,2)) - 1.0) > 1e-2
+        || scattering(pc) > 1e-3)
+    {
+        ROS_WARN_STREAM("error: pca of plane\n" << pc.eigenvalues.transpose() << "\n" << pc.eigenvectors);
+        ret = false;
+    }
+
+    // batch: neighborhoods are index lists into points
+    std::vector<std::vector<size_t> > neighborhoods(100);
+    for(size_t i=0; i<neighborhoods.size(); i++)
+    {
+        neighborhoods[i] = random::uniform_numbers(size_t(0), points.size() - 1, 50);
+    }
+    std::vector<PCA> pcs = pca(points, neighborhoods);
+
+    for(size_t i=0; i<neighborhoods.size(); i++)
+    {
+        std::vector<geometry_msgs::Point> neighbors;
+        for(const size_t id : neighborhoods[i])
+        {
+            neighbors.push_back(points[id]);
+        }
+
+        PCA expected = pca(neighbors);
+        if((expected.eigenvalues - pcs[i].eigenvalues).norm() > 1e-9)
+        {
+            ROS_WARN_STREAM("error: batch pca " << i);
+            ret = false;
+        }
+    }
+
+    return ret;
+}
+
+bool testNormalFixed()
+{
+    bool ret = true;
+
+    Eigen::Vector3d mu1(1.0, 0.0, -1.0), mu2(0.5, 2.0, 0.0);
+    Eigen::Matrix3d cov1, cov2;
+    cov1 << 2.0, 0.3, 0.1,
+            0.3, 1.0, 0.2,
+            0.1, 0.2, 0.5;
+    cov2 = Eigen::Matrix3d::Identity() * 1.5;
+    cov2(0,1) = cov2(1,0) = -0.4;
+
+    stats::Normal3 A3(mu1, cov1), B3(mu2, cov2);
+    stats::Normal A(mu1, cov1), B(mu2, cov2);
+
+    Eigen::Vector3d x(0.2, 0.4, -0.3);
+
+    const std::vector<std::pair<double, double> > values = {
+        {A3.pdf(x), A.pdf(x)},
+        {A3.mahalanobisDist(x), A.mahalanobisDist(x)},
+        {stats::D_KL(A3, B3), stats::D_KL(A, B)},
+        {stats::fisher_information(A3, B3), stats::fisher_information(A, B)},
+        {stats::wasserstein(A3, B3), stats::wasserstein(A, B)},
+        {stats::hellinger(A3, B3), stats::hellinger(A, B)},
+        {stats::H(A3), stats::H(A)},
+        {stats::H(A3, B3), stats::H(A, B)}
+    };
+
+    for(size_t i=0; i<values.size(); i++)
+    {
+        if(std::fabs(values[i].first - values[i].second) > 1e-9)
+        {
+            ROS_WARN_STREAM("error: fixed vs dynamic normal, value " << i 
+                << ": " << values[i].first << " != " << values[i].second);
+            ret = false;
+        }
+    }
+
+    stats::Normal3 F3 = A3.fuse(B3);
+    stats::Normal F = A.fuse(B);
+    stats::Normal3 S3 = A3.transform(Eigen::Matrix3d(cov2)).add(B3);
+    stats::Normal S = A.transform(Eigen::MatrixXd(cov2)).add(B);
+    if((F3.mean() - F.mean()).norm() > 1e-9 || (F3.cov() - F.cov()).norm() > 1e-9
+        || (S3.mean() - S.mean()).norm() > 1e-9 || (S3.cov() - S.cov()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: fixed vs dynamic normal, fuse/transform/add");
+        ret = false;
+    }
+
+    stats::Normal3 fit = stats::Normal3::fit(A3.samples(100000));
+    if((fit.mean() - mu1).norm() > 0.05 || (fit.cov() - cov1).norm() > 0.05)
+    {
+        ROS_WARN_STREAM("error: fixed normal, sample fit\n" << fit.mean() << "\n" << fit.cov());
+        ret = false;
+    }
+
+    // other sizes
+    stats::Normal2 N2(Eigen::Vector2d::Zero(), Eigen::Matrix2d::Identity());
+    stats::Normal6 N6(Eigen::Matrix<double,6,1>::Zero(), Eigen::Matrix<double,6,6>::Identity());
+    if(std::fabs(N2.pdf(Eigen::Vector2d::Zero()) - 1.0 / (2.0 * M_PI)) > 1e-12
+        || std::fabs(stats::H(N6) - 3.0 * (1.0 + std::log(2.0 * M_PI))) > 1e-12)
+    {
+        ROS_WARN_STREAM("error: Normal2/Normal6");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testNormalCholesky()
+{
+    bool ret = true;
+
+    Eigen::Vector3d mu(1.0, 2.0, 3.0);
+    Eigen::Matrix3d cov;
+    cov << 2.0, 0.3, 0.1,
+           0.3, 1.0, 0.2,
+           0.1, 0.2, 0.5;
+    stats::Normal3 N(mu, cov);
+
+    Eigen::Vector3d x(0.5, 1.5, 3.5);
+    const Eigen::Vector3d d = x - mu;
+    const double maha = d.dot(cov.inverse() * d);
+    const double pdf = std::exp(-0.5 * maha) / std::sqrt(std::pow(2.0 * M_PI, 3) * cov.determinant());
+
+    if(std::fabs(N.mahalanobisDist(x) - maha) > 1e-12 
+        || std::fabs(N.pdf(x) - pdf) > 1e-12
+        || std::fabs(N.logpdf(x) - std::log(pdf)) > 1e-12
+        || std::fabs(N.covDet() - cov.determinant()) > 1e-12
+        || (N.covInv() - cov.inverse()).norm() > 1e-12)
+    {
+        ROS_WARN_STREAM("error: cholesky based normal");
+        ret = false;
+    }
+
+    // high dimensions: det(cov) underflows, logpdf does not
+    const int dim = 400;
+    stats::Normal Nhigh(Eigen::VectorXd::Zero(dim), Eigen::MatrixXd::Identity(dim, dim) * 0.01);
+    const double logpdf = Nhigh.logpdf(Eigen::VectorXd::Zero(dim));
+    const double expected = -0.5 * dim * std::log(2.0 * M_PI * 0.01);
+    if(Nhigh.covDet() != 0.0 || std::fabs(logpdf - expected) > 1e-9)
+    {
+        ROS_WARN_STREAM("error: high dimensional logpdf " << logpdf << " != " << expected);
+        ret = false;
+    }
+
+    // construction is lazy: errors only on use
+    stats::Normal2 Nsingular(Eigen::Vector2d::Zero(), Eigen::Matrix2d::Zero());
+    bool exception_throwed = false;
+    try {
+        Nsingular.pdf(Eigen::Vector2d(0.0, 0.0));
+    } catch(std::runtime_error& ex) {
+        exception_throwed = true;
+    }
+    ret &= exception_throwed;
+
+    // copies keep computed caches and compute the others on use
+    stats::Normal3 Ncopy = N;
+    stats::Normal3 Nlazy(mu, cov);
+    stats::Normal3 Nassigned;
+    Nassigned = Nlazy;
+    if(std::fabs(Ncopy.logpdf(x) - N.logpdf(x)) > 1e-12
+        || std::fabs(Nassigned.logpdf(x) - N.logpdf(x)) > 1e-12
+        || (Ncopy.covInv() - N.covInv()).norm() > 1e-12)
+    {
+        ROS_WARN_STREAM("error: copied normal");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testNormalBatch()
+{
+    bool ret = true;
+
+    Eigen::Vector3d mu(1.0, 2.0, 3.0);
+    Eigen::Matrix3d cov;
+    cov << 2.0, 0.3, 0.1,
+           0.3, 1.0, 0.2,
+           0.1, 0.2, 0.5;
+    stats::Normal3 N3(mu, cov);
+    stats::Normal N(mu, cov);
+
+    Eigen::Matrix3Xd X = N3.samples(5000);
+
+    Eigen::VectorXd logp = N3.logpdf(X);
+    Eigen::VectorXd logp_par = N3.logpdf(X, true);
+    Eigen::VectorXd p = N.pdf(X, true);
+    Eigen::VectorXd maha = N.mahalanobisDist(X);
+
+    for(Eigen::Index i=0; i<X.cols(); i++)
+    {
+        const Eigen::Vector3d x = X.col(i);
+        if(std::fabs(logp(i) - N3.logpdf(x)) > 1e-9
+            || std::fabs(logp_par(i) - logp(i)) > 1e-12
+            || std::fabs(p(i) - N3.pdf(x)) > 1e-12
+            || std::fabs(maha(i) - N3.mahalanobisDist(x)) > 1e-9)
+        {
+            ROS_WARN_STREAM("error: batch pdf at sample " << i);
+            ret = false;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+bool testInformationFusion()
+{
+    bool ret = true;
+
+    std::vector<stats::Normal3> measurements;
+    for(size_t i=0; i<10; i++)
+    {
+        Eigen::Vector3d mu = Eigen::Vector3d::Random();
+        Eigen::Matrix3d A = Eigen::Matrix3d::Random();
+        Eigen::Matrix3d cov = A * A.transpose() + Eigen::Matrix3d::Identity() * 0.1;
+        measurements.push_back(stats::Normal3(mu, cov));
+    }
+
+    // pairwise reference
+    stats::Normal3 pairwise = measurements[0];
+    for(size_t i=1; i<measurements.size(); i++)
+    {
+        pairwise = pairwise.fuse(measurements[i]);
+    }
+
+    stats::Normal3 fused = stats::fuse(measurements);
+    if((fused.mean() - pairwise.mean()).norm() > 1e-9 
+        || (fused.cov() - pairwise.cov()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: information fusion\n" << fused.cov() << "\n" << pairwise.cov());
+        ret = false;
+    }
+
+    // incremental removal
+    stats::InformationFusion3 fusion;
+    for(const stats::Normal3& N : measurements)
+    {
+        fusion.add(N);
+    }
+    fusion.remove(measurements.back());
+    measurements.pop_back();
+
+    stats::Normal3 fused_removed = fusion.normal();
+    stats::Normal3 fused_expected = stats::fuse(measurements);
+    if(fusion.size() != 9 
+        || (fused_removed.mean() - fused_expected.mean()).norm() > 1e-9 
+        || (fused_removed.cov() - fused_expected.cov()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: information fusion remove");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testGaussianMixture()
+{
+    bool ret = true;
+
+    random::seed(42);
+
+    // two well separated clusters
+    stats::GaussianMixture gt(
+        {0.3, 0.7}, 
+        {
+            stats::Normal(Eigen::Vector3d(-5.0, 0.0, 0.0), Eigen::Matrix3d::Identity() * 0.5),
+            stats::Normal(Eigen::Vector3d(5.0, 1.0, 0.0), Eigen::Matrix3d::Identity() * 0.2)
+        });
+
+    Eigen::MatrixXd X = gt.samples(5000);
+    stats::GaussianMixture gmm = stats::GaussianMixture::fit(X, 2);
+
+    // order of components is arbitrary
+    size_t k0 = (gmm.components()[0].mean()(0) < 0.0) ? 0 : 1;
+    size_t k1 = 1 - k0;
+
+    if(std::fabs(gmm.weights()[k0] - 0.3) > 0.05
+        || (gmm.components()[k0].mean() - gt.components()[0].mean()).norm() > 0.1
+        || (gmm.components()[k1].mean() - gt.components()[1].mean()).norm() > 0.1
+        || (gmm.components()[k1].cov() - gt.components()[1].cov()).norm() > 0.05)
+    {
+        ROS_WARN_STREAM("error: gmm fit. weights " << gmm.weights()[0] << ", " << gmm.weights()[1]);
+        ret = false;
+    }
+
+    std::vector<size_t> labels = gmm.predict(X, true);
+    if(labels[0] != gmm.predict(Eigen::VectorXd(X.col(0))))
+    {
+        ROS_WARN_STREAM("error: gmm predict");
+        ret = false;
+    }
+
+    Eigen::VectorXd p = gmm.pdf(X, true);
+    if(std::fabs(p(0) - gmm.pdf(Eigen::VectorXd(X.col(0)))) > 1e-12)
+    {
+        ROS_WARN_STREAM("error: gmm pdf");
+        ret = false;
+    }
+
+    Eigen::MatrixXd R = gmm.responsibilities(X, true);
+    if((R.rowwise().sum().array() - 1.0).abs().maxCoeff() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: gmm responsibilities");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testDivergenceMatrix()
+{
+    bool ret = true;
+
+    std::vector<stats::Normal> Ns;
+    for(size_t i=0; i<20; i++)
+    {
+        Eigen::Matrix3d A = Eigen::Matrix3d::Random();
+        Ns.push_back(stats::Normal(Eigen::Vector3d::Random(), A * A.transpose() + Eigen::Matrix3d::Identity() * 0.1));
+    }
+
+    Eigen::MatrixXd KL = stats::divergenceMatrix(Ns, stats::Divergence::KULLBACK_LEIBLER);
+    Eigen::MatrixXd F = stats::divergenceMatrix(Ns, stats::Divergence::FISHER);
+    Eigen::MatrixXd W = stats::divergenceMatrix(Ns, stats::Divergence::WASSERSTEIN);
+    Eigen::MatrixXd He = stats::divergenceMatrix(Ns, stats::Divergence::HELLINGER);
+    Eigen::MatrixXd CE = stats::divergenceMatrix(Ns, stats::Divergence::CROSS_ENTROPY);
+
+    for(size_t i=0; i<Ns.size(); i++)
+    {
+        for(size_t j=0; j<Ns.size(); j++)
+        {
+            if(std::fabs(KL(i,j) - stats::D_KL(Ns[i], Ns[j])) > 1e-6
+                || std::fabs(F(i,j) - stats::fisher_information(Ns[i], Ns[j])) > 1e-6
+                || std::fabs(W(i,j) - stats::wasserstein(Ns[i], Ns[j])) > 1e-6
+                || std::fabs(He(i,j) - stats::hellinger(Ns[i], Ns[j])) > 1e-6
+                || std::fabs(CE(i,j) - stats::H(Ns[i], Ns[j])) > 1e-6)
+            {
+                ROS_WARN_STREAM("error: divergence matrix at " << i << ", " << j);
+                return false;
+            }
+        }
+    }
+
+    // degenerate covariance: the error reaches the caller
+    Ns.push_back(stats::Normal(Eigen::Vector3d::Zero(), Eigen::Matrix3d::Zero()));
+    try {
+        stats::divergenceMatrix(Ns, stats::Divergence::KULLBACK_LEIBLER);
+        ROS_WARN_STREAM("error: divergence matrix of a degenerate normal");
+        ret = false;
+    } catch(const std::runtime_error& ex) {
+
+    }
+
+    return ret;
+}
+
+bool testNormalTransform()
+{
+    bool ret = true;
+
+    geometry_msgs::Transform T;
+    T.translation.x = 1.0;
+    T.translation.y = -2.0;
+    T.translation.z = 0.5;
+    T.rotation = rpy2quat(0.1, -0.3, 1.2);
+
+    Eigen::Affine3d Te;
+    convert(T, Te);
+
+    Eigen::Matrix3d A = Eigen::Matrix3d::Random();
+    stats::Normal3 Np(Eigen::Vector3d(1.0, 2.0, 3.0), A * A.transpose() + Eigen::Matrix3d::Identity() * 0.1);
+
+    // point: same as the linear transform plus translation
+    stats::Normal3 Np_t = stats::transform(T, Np);
+    Eigen::Matrix3d R = Te.linear();
+    if((Np_t.mean() - Te * Np.mean()).norm() > 1e-9 
+        || (Np_t.cov() - R * Np.cov() * R.transpose()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: point normal transform");
+        ret = false;
+    }
+
+    // unscented transform is exact for affine maps
+    stats::Normal3 Np_ut = stats::unscented_transform<3>(Np, 
+        [&](const Eigen::Vector3d& x) -> Eigen::Vector3d { return Te * x; });
+    if((Np_ut.mean() - Np_t.mean()).norm() > 1e-9 
+        || (Np_ut.cov() - Np_t.cov()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: unscented transform");
+        ret = false;
+    }
+
+    // pose: first order matches the unscented transform for small uncertainties
+    stats::Normal6::Vector mu;
+    mu << 1.0, 2.0, 3.0, 0.2, 0.1, -0.5;
+    Eigen::Matrix<double, 6, 6> B = Eigen::Matrix<double, 6, 6>::Random();
+    stats::Normal6 Nq(mu, (B * B.transpose() + Eigen::Matrix<double, 6, 6>::Identity()) * 1e-5);
+
+    stats::Normal6 Nq_t = stats::transform(T, Nq);
+    stats::Normal6 Nq_ut = stats::unscented_transform<6>(Nq, 
+        [&](const stats::Normal6::Vector& x) -> stats::Normal6::Vector {
+            const Eigen::Matrix3d Rx = (Eigen::AngleAxisd(x(5), Eigen::Vector3d::UnitZ())
+                * Eigen::AngleAxisd(x(4), Eigen::Vector3d::UnitY())
+                * Eigen::AngleAxisd(x(3), Eigen::Vector3d::UnitX())).toRotationMatrix();
+            const Eigen::Matrix3d Ry = R * Rx;
+            stats::Normal6::Vector y;
+            y.head<3>() = Te * x.head<3>();
+            y.tail<3>() = Eigen::Vector3d(
+                std::atan2(Ry(2,1), Ry(2,2)), 
+                std::asin(-Ry(2,0)), 
+                std::atan2(Ry(1,0), Ry(0,0)));
+            return y;
+        });
+
+    if((Nq_t.mean() - Nq_ut.mean()).norm() > 1e-4 
+        || (Nq_t.cov() - Nq_ut.cov()).norm() > 1e-6)
+    {
+        ROS_WARN_STREAM("error: pose normal transform\n" << Nq_t.cov() << "\n" << Nq_ut.cov());
+        ret = false;
+    }
+
+    // batch
+    std::vector<stats::Normal6> Ns(100, Nq);
+    std::vector<stats::Normal6> Ns_t = stats::transform(T, Ns, true);
+    if(Ns_t.size() != Ns.size() || (Ns_t.back().cov() - Nq_t.cov()).norm() > 1e-12)
+    {
+        ROS_WARN_STREAM("error: batch normal transform");
+        ret = false;
+    }
+
+    // dynamic
+    stats::Normal Nd = stats::transform(T, stats::Normal(Np.mean(), Np.cov()));
+    if((Nd.mean() - Np_t.mean()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: dynamic normal transform");
+        ret = false;
+    }
+
+    // errors in the parallel batches reach the caller
+    std::vector<stats::Normal> Nds(10, stats::Normal(Np.mean(), Np.cov()));
+    Nds[7] = stats::Normal(Eigen::Vector2d::Zero(), Eigen::Matrix2d::Identity());
+    try {
+        stats::transform(T, Nds, true);
+        ROS_WARN_STREAM("error: batch transform of a 2D normal");
+        ret = false;
+    } catch(const std::runtime_error& ex) {
+
+    }
+
+    std::vector<stats::Normal3> Nps(10, Np);
+    Nps[5] = stats::Normal3(Np.mean(), Eigen::Matrix3d::Zero());
+    try {
+        stats::unscented_transform<3>(Nps, 
+            [&](const Eigen::Vector3d& x) -> Eigen::Vector3d { return Te * x; }, true);
+        ROS_WARN_STREAM("error: batch unscented transform of a degenerate normal");
+        ret = false;
+    } catch(const std::runtime_error& ex) {
+
+    }
+
+    return ret;
+}
+
+bool testKalmanFilter()
+{
+    bool ret = true;
+
+    using Matrix6 = stats::Normal6::Matrix;
+    using Vector6 = stats::Normal6::Vector;
+
+    Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+    stats::Normal6 prior(Vector6::Random(), A * A.transpose() + Matrix6::Identity());
+
+    std::vector<stats::Normal6> measurements;
+    for(size_t i=0; i<5; i++)
+    {
+        Eigen::Matrix<double, 6, 6> B = Eigen::Matrix<double, 6, 6>::Random();
+        measurements.push_back(stats::Normal6(Vector6::Random(), B * B.transpose() + Matrix6::Identity()));
+    }
+
+    // direct observation of the state: same as fusion
+    stats::KalmanFilter6 kf(prior);
+    kf.update(measurements, Matrix6::Identity());
+
+    std::vector<stats::Normal6> all = measurements;
+    all.push_back(prior);
+    stats::Normal6 fused = stats::fuse(all);
+
+    if((kf.state() - fused.mean()).norm() > 1e-9 
+        || (kf.covariance() - fused.cov()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: kalman update");
+        ret = false;
+    }
+
+    // extended versions with linear functions equal the linear ones
+    Matrix6 F = Matrix6::Identity();
+    F.block<3,3>(0,3) = Eigen::Matrix3d::Identity() * 0.01;
+    Matrix6 Q = Matrix6::Identity() * 1e-3;
+    Eigen::Matrix<double, 3, 6> H = Eigen::Matrix<double, 3, 6>::Zero();
+    H.block<3,3>(0,0) = Eigen::Matrix3d::Identity();
+    Eigen::Vector3d z(1.0, 2.0, 3.0);
+    Eigen::Matrix3d R = Eigen::Matrix3d::Identity() * 0.1;
+
+    stats::KalmanFilter6 kf_lin(prior), kf_ext(prior);
+    kf_lin.predict(F, Q);
+    kf_lin.update(z, H, R);
+    kf_ext.predict([&](const Vector6& x) -> Vector6 { return F * x; }, F, Q);
+    kf_ext.update(z, [&](const Vector6& x) -> Eigen::Vector3d { return H * x; }, H, R);
+
+    if((kf_lin.state() - kf_ext.state()).norm() > 1e-9 
+        || (kf_lin.covariance() - kf_ext.covariance()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: extended kalman");
+        ret = false;
+    }
+
+    // pose measurements, wrapped yaw residual
+    Vector6 mu = Vector6::Zero();
+    mu(5) = M_PI - 0.05;
+    stats::KalmanFilter6 kf_pose(mu, Matrix6::Identity() * 0.1);
+
+    geometry_msgs::PoseWithCovariance pose;
+    Vector6 mu_meas = Vector6::Zero();
+    mu_meas(5) = -M_PI + 0.05;
+    convert(stats::Normal6(mu_meas, Matrix6::Identity() * 0.1), pose);
+    kf_pose.update(pose, Matrix6::Identity());
+
+    // halfway between both yaws is pi, not 0
+    if(std::fabs(std::fabs(kf_pose.state()(5)) - M_PI) > 1e-6)
+    {
+        ROS_WARN_STREAM("error: kalman pose update, yaw " << kf_pose.state()(5));
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testNDT()
+{
+    bool ret = true;
+
+    // two noisy walls and a floor, away from voxel borders
+    auto wall_point = [](size_t i, double margin) {
+        geometry_msgs::Point32 p;
+        double u = std::floor(random::uniform_number(-5.0, 5.0)) + 0.5 + random::uniform_number(-margin, margin);
+        double v = std::floor(random::uniform_number(0.0, 3.0)) + 0.5 + random::uniform_number(-margin, margin);
+        double n = random::uniform_number(-0.02, 0.02);
+        switch(i % 3)
+        {
+            case 0: p.x = u; p.y = 2.5 + n; p.z = v; break;
+            case 1: p.x = -2.5 + n; p.y = u; p.z = v; break;
+            default: p.x = u; p.y = v - 1.0; p.z = 0.5 + n; break;
+        }
+        return p;
+    };
+
+    sensor_msgs::PointCloud cloud;
+    for(size_t i=0; i<20000; i++)
+    {
+        cloud.points.push_back(wall_point(i, 0.5));
+    }
+
+    stats::NDTMap map(1.0);
+    map.insert(cloud);
+
+    // incremental insertion equals one-shot insertion
+    sensor_msgs::PointCloud half1, half2;
+    half1.points.assign(cloud.points.begin(), cloud.points.begin() + 10000);
+    half2.points.assign(cloud.points.begin() + 10000, cloud.points.end());
+    stats::NDTMap map_inc(1.0);
+    map_inc.insert(half1);
+    map_inc.insert(half2);
+
+    if(map.size() == 0 || map.size() != map_inc.size())
+    {
+        ROS_WARN_STREAM("error: ndt size " << map.size() << " vs " << map_inc.size());
+        return false;
+    }
+
+    Eigen::Vector3d probe(0.3, 2.5, 1.2);
+    const stats::Normal3* c1 = map.cell(probe);
+    const stats::Normal3* c2 = map_inc.cell(probe);
+    if(c1 == nullptr || c2 == nullptr 
+        || (c1->mean() - c2->mean()).norm() > 1e-9
+        || (c1->cov() - c2->cov()).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: ndt incremental insertion");
+        ret = false;
+    }
+
+    // small motions keep the query points in their voxels
+    sensor_msgs::PointCloud query;
+    for(size_t i=0; i<2000; i++)
+    {
+        query.points.push_back(wall_point(i, 0.2));
+    }
+
+    stats::NDTMap::Vector6 x0 = stats::NDTMap::Vector6::Zero();
+    stats::NDTMap::Vector6 x1;
+    x1 << 0.05, -0.03, 0.02, 0.01, -0.02, 0.03;
+
+    stats::NDTMap::Vector6 g;
+    double s0 = map.score(query, x0);
+    double s1 = map.score(query, x1, &g);
+    if(s0 <= s1)
+    {
+        ROS_WARN_STREAM("error: ndt score " << s0 << " <= " << s1);
+        ret = false;
+    }
+
+    // gradient vs central differences
+    const double h = 1e-6;
+    for(size_t i=0; i<6; i++)
+    {
+        stats::NDTMap::Vector6 xp = x1, xm = x1;
+        xp(i) += h;
+        xm(i) -= h;
+        double num = (map.score(query, xp) - map.score(query, xm)) / (2.0 * h);
+        if(std::fabs(num - g(i)) > 1e-3 * std::max(1.0, std::fabs(num)))
+        {
+            ROS_WARN_STREAM("error: ndt gradient " << i << ": " << g(i) << " vs " << num);
+            ret = false;
+        }
+    }
+
+    geometry_msgs::Transform T;
+    T.rotation.w = 1.0;
+    if(std::fabs(map.score(query, T) - s0) > 1e-9)
+    {
+        ROS_WARN_STREAM("error: ndt transform score");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testMarginalCondition()
+{
+    bool ret = true;
+
+    Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+    stats::Normal6 N(stats::Normal6::Vector::Random(), A * A.transpose() + stats::Normal6::Matrix::Identity() * 0.1);
+
+    // marginal: x, y, yaw
+    stats::Normal3 M = N.marginal<3>({0, 1, 5});
+    stats::Normal Md = N.marginal({0, 1, 5});
+    if(std::fabs(M.cov()(2,2) - N.cov()(5,5)) > 1e-12 
+        || std::fabs(M.cov()(0,2) - N.cov()(0,5)) > 1e-12
+        || (M.mean() - Md.mean()).norm() > 1e-12
+        || (M.cov() - Md.cov()).norm() > 1e-12)
+    {
+        ROS_WARN_STREAM("error: marginal");
+        ret = false;
+    }
+
+    // condition: Schur complement on the covariance
+    Eigen::Vector3d values(0.1, -0.2, 0.3);
+    stats::Normal3 C = N.condition<3>({1, 3, 4}, values);
+
+    const std::vector<size_t> a = {0, 2, 5}, b = {1, 3, 4};
+    Eigen::Matrix3d S_aa, S_ab, S_bb;
+    Eigen::Vector3d mu_a, mu_b;
+    for(size_t i=0; i<3; i++)
+    {
+        mu_a(i) = N.mean()(a[i]);
+        mu_b(i) = N.mean()(b[i]);
+        for(size_t j=0; j<3; j++)
+        {
+            S_aa(i,j) = N.cov()(a[i], a[j]);
+            S_ab(i,j) = N.cov()(a[i], b[j]);
+            S_bb(i,j) = N.cov()(b[i], b[j]);
+        }
+    }
+    Eigen::Vector3d mean_expected = mu_a + S_ab * S_bb.inverse() * (values - mu_b);
+    Eigen::Matrix3d cov_expected = S_aa - S_ab * S_bb.inverse() * S_ab.transpose();
+
+    stats::Normal Cd = stats::Normal(N.mean(), N.cov()).condition(
+        {1, 3, 4}, Eigen::VectorXd(values));
+    if((C.mean() - mean_expected).norm() > 1e-9 
+        || (C.cov() - cov_expected).norm() > 1e-9
+        || (Cd.mean() - mean_expected).norm() > 1e-9)
+    {
+        ROS_WARN_STREAM("error: condition");
+        ret = false;
+    }
+
+    // 6x6 message layout
+    geometry_msgs::PoseWithCovariance pose;
+    convert(N, pose);
+    Eigen::Matrix3d cov_xy_yaw = stats::marginal<3>(pose.covariance, {0, 1, 5});
+    if((cov_xy_yaw - M.cov()).norm() > 1e-12)
+    {
+        ROS_WARN_STREAM("error: marginal of covariance array");
+        ret = false;
+    }
+
+    try {
+        stats::marginal<2>(pose.covariance, {0, 6});
+        ROS_WARN_STREAM("error: marginal index out of range accepted");
+        ret = false;
+    } catch(const std::runtime_error& ex) {
+
+    }
+
+    stats::Normal_<5> C5 = stats::condition<1>(pose, {2}, Eigen::Matrix<double, 1, 1>(0.0));
+    if(C5.dim() != 5)
+    {
+        ROS_WARN_STREAM("error: condition pose");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool testRansac()
+{
+    bool ret = true;
+    random::Engine gen(21);
+
+    // ground plane z = 0.1 * x + 1 with noise, 40% clutter above it
+    sensor_msgs::PointCloud cloud;
+    for(size_t i=0; i<5000; i++)
+    {
+        geometry_msgs::Point32 p;
+        p.x = random::uniform_number(gen, -10.0, 10.0);
+        p.y = random::uniform_number(gen, -10.0, 10.0);
+        if(i % 5 < 3)
+        {
+            p.z = 0.1 * p.x + 1.0 + random::normal_number(gen, 0.0, 0.01);
+        } else {
+            p.z = 0.1 * p.x + 1.0 + random::uniform_number(gen, 0.5, 2.0);
+        }
+        cloud.points.push_back(p);
+    }
+
+    stats::RansacParams params;
+    params.threshold = 0.05;
+    params.seed = 3;
+    auto plane = stats::ransac_plane(cloud, params);
+    auto plane2 = stats::ransac_plane(cloud, params);
+    Eigen::Vector3d n_true = Eigen::Vector3d(-0.1, 0.0, 1.0).normalized();
+    const double n_err = std::min((plane.model.normal() - n_true).norm(), (plane.model.normal() + n_true).norm());
+    if(!plane.success || n_err > 1e-3 
+        || std::fabs(plane.model.signedDistance(Eigen::Vector3d(0.0, 0.0, 1.0))) > 0.005
+        || plane.inliers.size() < 2900 || plane.inliers.size() > 3000
+        || plane.iterations >= params.max_iterations)
+    {
+        ROS_WARN_STREAM("error: ransac plane " << plane.model.coeffs().transpose() 
+            << ", " << plane.inliers.size() << " inliers, " << plane.iterations << " iterations");
+        ret = false;
+    }
+    if(plane.inliers != plane2.inliers || plane.model.coeffs() != plane2.model.coeffs())
+    {
+        ROS_WARN_STREAM("error: ransac not reproducible");
+        ret = false;
+    }
+
+    // line along (1, 1, 0) through (0, 0, 2), half outliers
+    std::vector<geometry_msgs::Point> line_points;
+    for(size_t i=0; i<1000; i++)
+    {
+        geometry_msgs::Point p;
+        if(i % 2)
+        {
+            const double t = random::uniform_number(gen, -5.0, 5.0);
+            p.x = t + random::normal_number(gen, 0.0, 0.005);
+            p.y = t + random::normal_number(gen, 0.0, 0.005);
+            p.z = 2.0 + random::normal_number(gen, 0.0, 0.005);
+        } else {
+            p.x = random::uniform_number(gen, -5.0, 5.0);
+            p.y = random::uniform_number(gen, -5.0, 5.0);
+            p.z = random::uniform_number(gen, -5.0, 5.0);
+        }
+        line_points.push_back(p);
+    }
+    params.threshold = 0.03;
+    auto line = stats::ransac_line(line_points, params);
+    if(!line.success || std::fabs(std::fabs(line.model.direction().dot(Eigen::Vector3d(1.0, 1.0, 0.0).normalized())) - 1.0) > 1e-4
+        || line.model.distance(Eigen::Vector3d(1.0, 1.0, 2.0)) > 0.005 || line.inliers.size() < 500)
+    {
+        ROS_WARN_STREAM("error: ransac line " << line.model.origin().transpose() 
+            << " | " << line.model.direction().transpose() << ", " << line.inliers.size() << " inliers");
+        ret = false;
+    }
+
+    // rigid transform with 30% wrong correspondences
+    Eigen::Isometry3d T = Eigen::Isometry3d::Identity();
+    T.linear() = Eigen::AngleAxisd(0.4, Eigen::Vector3d(1.0, 2.0, 3.0).normalized()).toRotationMatrix();
+    T.translation() << 1.0, -2.0, 0.5;
+    std::vector<geometry_msgs::Point> source, target;
+    for(size_t i=0; i<300; i++)
+    {
+        geometry_msgs::Point s, t;
+        s.x = random::uniform_number(gen, -3.0, 3.0);
+        s.y = random::uniform_number(gen, -3.0, 3.0);
+        s.z = random::uniform_number(gen, -3.0, 3.0);
+        Eigen::Vector3d ts = T * Eigen::Vector3d(s.x, s.y, s.z);
+        if(i % 10 < 3)
+        {
+            ts += Eigen::Vector3d(random::uniform_number(gen, 1.0, 3.0), 0.0, 0.0);
+        }
+        t.x = ts.x() + random::normal_number(gen, 0.0, 0.001);
+        t.y = ts.y();
+        t.z = ts.z();
+        source.push_back(s);
+        target.push_back(t);
+    }
+    params.threshold = 0.01;
+    params.score = stats::RansacScore::RANSAC;
+    auto rigid = stats::ransac_rigid(source, target, params);
+    if(!rigid.success || !rigid.model.isApprox(T, 1e-3) || rigid.inliers.size() != 210)
+    {
+        ROS_WARN_STREAM("error: ransac rigid " << rigid.inliers.size() << " inliers\n" << rigid.model.matrix());
+        ret = false;
+    }
+
+    return ret;
+}
+
+std::string result(bool res)
+{
+    if(res)
+    {
+        return "success";
+    } else {
+        return "failure";
+    }
+}
+
+void test( std::string name, bool (*f)(void) )
+{
+    std::cout << "-- " << name << ": " << result(f()) << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "rosmath_stats_test_node");
+
+    std::cout << "Tests of rosmath library: Stats" << std::endl;
+
+    test("Quantiles", testQuantiles);
+    test("TDigest", testTDigest);
+    test("Point Stats", testPointStats);
+    test("Sliding Window", testSlidingWindow);
+    test("PCA", testPCA);
+    test("Normal Fixed Size", testNormalFixed);
+    test("Normal Cholesky", testNormalCholesky);
+    test("Normal Batch", testNormalBatch);
+    test("Information Fusion", testInformationFusion);
+    test("Gaussian Mixture", testGaussianMixture);
+    test("Divergence Matrix", testDivergenceMatrix);
+    test("Normal Transform", testNormalTransform);
+    test("Kalman Filter", testKalmanFilter);
+    test("NDT", testNDT);
+    test("Marginal Condition", testMarginalCondition);
+    test("RANSAC", testRansac);
+
+    return 0;
+}